@@ -0,0 +1,262 @@
+#pragma once
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "road_network.h"
+
+// Antrian berkapasitas tetap antar tahap pipeline: push menunggu jika penuh,
+// pop menunggu jika kosong dan mengembalikan false setelah close() dan antrian habis.
+template <typename T>
+class BoundedQueue {
+private:
+    mutex lock;
+    condition_variable notFull, notEmpty;
+    deque<T> items;
+    size_t capacity;
+    bool closed = false;
+    
+public:
+    explicit BoundedQueue(size_t capacity) : capacity(capacity) {}
+    
+    void push(T item) {
+        unique_lock<mutex> guard(lock);
+        notFull.wait(guard, [&] { return items.size() < capacity; });
+        items.push_back(move(item));
+        notEmpty.notify_one();
+    }
+    
+    bool pop(T& item) {
+        unique_lock<mutex> guard(lock);
+        notEmpty.wait(guard, [&] { return !items.empty() || closed; });
+        if (items.empty()) return false;
+        item = move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+    
+    void close() {
+        lock_guard<mutex> guard(lock);
+        closed = true;
+        notEmpty.notify_all();
+    }
+};
+
+// Semaphore penghitung sederhana: acquire menunggu sampai ada izin, release menambah satu izin
+class CountingSemaphore {
+private:
+    mutex lock;
+    condition_variable available;
+    size_t permits;
+    
+public:
+    explicit CountingSemaphore(size_t permits) : permits(permits) {}
+    
+    void acquire() {
+        unique_lock<mutex> guard(lock);
+        available.wait(guard, [&] { return permits > 0; });
+        permits--;
+    }
+    
+    void release() {
+        lock_guard<mutex> guard(lock);
+        permits++;
+        available.notify_one();
+    }
+};
+
+struct BatchJob {
+    long long id;
+    int start, end; // Indeks 0-based; -1 jika baris input tidak valid
+    string error;
+};
+
+// Ambil satu ujung rute dari line mulai pos: kata tanpa spasi atau "nama dalam kutip"
+inline bool nextEndpoint(const string& line, size_t& pos, string& token) {
+    while (pos < line.size() && isspace((unsigned char)line[pos])) pos++;
+    if (pos >= line.size()) return false;
+    if (line[pos] == '"') {
+        size_t close = line.find('"', pos + 1);
+        if (close == string::npos) return false;
+        token = "\"" + line.substr(pos + 1, close - pos - 1);
+        pos = close + 1;
+        return true;
+    }
+    size_t begin = pos;
+    while (pos < line.size() && !isspace((unsigned char)line[pos])) pos++;
+    token = line.substr(begin, pos - begin);
+    return true;
+}
+
+// Ujung rute ke indeks lokasi 0-based: nomor lokasi (mulai dari 1), @x,y (lokasi terdekat)
+// atau "nama" (hasil teratas pencarian nama). -1 dan error terisi jika tidak bisa dipakai.
+inline int resolveEndpoint(RoadNetwork& network, const string& token, string& error) {
+    if (token[0] == '"') {
+        vector<NameMatch> matches = network.findLocationsByName(string_view(token).substr(1), 1);
+        if (matches.empty()) {
+            error = "nama lokasi tidak ditemukan";
+            return -1;
+        }
+        return matches[0].location;
+    }
+    int x = 0, y = 0, index = 0;
+    char extra;
+    if (token[0] == '@') {
+        int location = -1;
+        if (sscanf(token.c_str() + 1, "%d,%d%c", &x, &y, &extra) == 2) location = network.nearestLocation(x, y);
+        if (location < 0) error = "koordinat tidak valid";
+        return location;
+    }
+    if (sscanf(token.c_str(), "%d", &index) == 1) {
+        if (index < 1 || index > network.numLocations) {
+            error = "nomor lokasi tidak dikenal: " + to_string(index) + " (1-" + to_string(network.numLocations) + ")";
+        } else if (network.isRemoved(index - 1)) {
+            error = "lokasi " + to_string(index) + " sudah dihapus";
+        } else {
+            return index - 1;
+        }
+        return -1;
+    }
+    error = "baris tidak valid";
+    return -1;
+}
+
+// Field rute untuk balasan JSON: start, end, distance_km (null jika tidak terhubung) dan path,
+// semua nomor lokasi mulai dari 1
+inline void appendRouteJson(string& json, int start, int end, const RouteResult& route) {
+    json += ",\"start\":" + to_string(start + 1) + ",\"end\":" + to_string(end + 1);
+    if (route.path.empty()) {
+        json += ",\"distance_km\":null,\"path\":[]";
+        return;
+    }
+    char number[64];
+    snprintf(number, sizeof(number), ",\"distance_km\":%.3f", route.distance * UNIT_TO_KM);
+    json += number;
+    json += ",\"path\":[";
+    for (size_t i = 0; i < route.path.size(); i++) {
+        if (i > 0) json += ',';
+        json += to_string(route.path[i] + 1);
+    }
+    json += ']';
+}
+
+struct BatchAnswer {
+    long long id;
+    string json;
+};
+
+// Mode batch tanpa menu: baca pasangan "awal tujuan" per baris (lihat resolveEndpoint),
+// selesaikan di pool solver, lalu tulis satu baris JSON per query dengan urutan sama seperti input.
+// Pipeline: reader -> antrian -> solver x N -> antrian -> writer (thread pemanggil).
+// Reader paling jauh QUEUE_CAPACITY query di depan baris yang terakhir ditulis, sehingga
+// jawaban yang menunggu disusun ulang di writer juga tidak lebih dari itu.
+// Dengan withStats, setiap baris memuat penghitung pencarian dan ringkasan sesi (JSON)
+// ditulis ke statsOut setelah semua query selesai.
+inline int runBatchQueries(RoadNetwork& network, istream& in, ostream& out, int threads = 0,
+                           bool withStats = false, ostream* statsOut = nullptr) {
+    const size_t QUEUE_CAPACITY = 4096;
+    int solverCount = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+    
+    // Preprocessing (misalnya CH) harus selesai sebelum query paralel dimulai
+    if (!network.prepareSearchMode() && statsOut) *statsOut << network.hierarchy.error() << ", memakai Dijkstra" << endl;
+    network.prepareLookup();
+    
+    BoundedQueue<BatchJob> jobs(QUEUE_CAPACITY);
+    BoundedQueue<BatchAnswer> answers(QUEUE_CAPACITY);
+    CountingSemaphore window(QUEUE_CAPACITY); // Satu izin per query yang belum ditulis
+    
+    thread reader([&] {
+        string line;
+        long long id = 0;
+        while (getline(in, line)) {
+            if (line.find_first_not_of(" \t\r") == string::npos) continue;
+            window.acquire();
+            BatchJob job = {id++, -1, -1, ""};
+            size_t pos = 0;
+            string first, second;
+            if (nextEndpoint(line, pos, first) && nextEndpoint(line, pos, second)) {
+                int start = resolveEndpoint(network, first, job.error);
+                int end = start < 0 ? -1 : resolveEndpoint(network, second, job.error);
+                if (start >= 0 && end >= 0) {
+                    job.start = start;
+                    job.end = end;
+                }
+            } else {
+                job.error = "baris tidak valid";
+            }
+            jobs.push(move(job));
+        }
+        jobs.close();
+    });
+    
+    atomic<int> activeSolvers(solverCount);
+    vector<thread> solvers;
+    for (int w = 0; w < solverCount; w++) {
+        solvers.emplace_back([&] {
+            BatchJob job;
+            string json;
+            char number[64];
+            while (jobs.pop(job)) {
+                json = "{\"id\":" + to_string(job.id);
+                if (job.start < 0) {
+                    json += ",\"error\":\"" + job.error + "\"}";
+                    answers.push({job.id, json});
+                    continue;
+                }
+                
+                auto began = chrono::steady_clock::now();
+                RouteResult route = network.findRoute(job.start, job.end);
+                double latency = chrono::duration<double, micro>(chrono::steady_clock::now() - began).count();
+                
+                appendRouteJson(json, job.start, job.end, route);
+                snprintf(number, sizeof(number), ",\"settled\":%d,\"latency_us\":%.1f", route.settledNodes, latency);
+                json += number;
+                if (withStats) {
+                    snprintf(number, sizeof(number), ",\"heap_pushes\":%lld,\"stale_pops\":%lld,\"relaxations\":%lld",
+                             route.counters.heapPushes, route.counters.stalePops(), route.counters.relaxations);
+                    json += number;
+                }
+                json += '}';
+                answers.push({job.id, json});
+            }
+            if (--activeSolvers == 0) answers.close();
+        });
+    }
+    
+    // Writer: susun ulang berdasarkan id agar output deterministik walau solver selesai acak
+    map<long long, string> pending;
+    long long nextId = 0;
+    BatchAnswer answer;
+    while (answers.pop(answer)) {
+        pending[answer.id] = move(answer.json);
+        while (!pending.empty() && pending.begin()->first == nextId) {
+            out << pending.begin()->second << '\n';
+            pending.erase(pending.begin());
+            nextId++;
+            window.release();
+        }
+    }
+    out.flush();
+    
+    reader.join();
+    for (thread& t : solvers) {
+        t.join();
+    }
+    if (withStats && statsOut) {
+        *statsOut << "{\"session\":" << network.sessionStats.toJson() << ",\"tree_cache\":{\"hits\":"
+                  << network.treeCache.hits() << ",\"misses\":" << network.treeCache.misses()
+                  << ",\"entries\":" << network.treeCache.size()
+                  << ",\"bytes\":" << network.treeCache.bytesUsed() << "}}" << endl;
+    }
+    return 0;
+}
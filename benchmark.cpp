@@ -0,0 +1,248 @@
+// Benchmark konstruksi graph dan query pada peta sintetis (khusus Linux).
+// Output: satu objek JSON per baris di stdout agar mudah di-diff antar commit;
+// progres ditulis ke stderr.
+//
+//   maps_bench [--sizes 1000,10000,100000] [--dist random,clustered] [--queries 1000]
+//              [--modes dijkstra,astar,bidirectional,bidirectional-astar,ch] [--seed 42]
+//              [--kernel scalar|sse2|avx2] [--build-threads 1,2,4,8]
+//
+// Setiap kombinasi (dist, ukuran) dijalankan di proses anak (fork) sehingga peak RSS
+// yang dilaporkan milik kombinasi itu sendiri, bukan sisa kombinasi sebelumnya.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "road_network.h"
+
+using namespace std;
+
+struct BenchConfig {
+    vector<int> sizes = {1000, 10000, 100000};
+    vector<string> distributions = {"random", "clustered"};
+    vector<SearchMode> modes = {MODE_DIJKSTRA, MODE_ASTAR, MODE_BIDIRECTIONAL, MODE_BIDIRECTIONAL_ASTAR,
+                                MODE_CONTRACTION_HIERARCHIES};
+    vector<int> buildThreads = {0}; // 0 = semua core; lebih dari satu nilai = laporan skala thread
+    int queries = 1000;
+    unsigned long long seed = 42;
+};
+
+// Peak RSS proses ini dalam KB
+long peakRssKb() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+double secondsSince(chrono::steady_clock::time_point began) {
+    return chrono::duration<double>(chrono::steady_clock::now() - began).count();
+}
+
+// Luas peta diskalakan dengan jumlah titik supaya kerapatannya mirip data bawaan
+// (jarak antar tetangga beberapa ratus unit, jauh di bawah MAX_DISTANCE buildGraph)
+LocationTable generatePoints(const string& distribution, int n, unsigned long long seed) {
+    mt19937_64 rng(seed);
+    int side = (int)(sqrt((double)n) * 400) + 1;
+    LocationTable table;
+    table.reserve(n, 0);
+    
+    if (distribution == "clustered") {
+        // Kota-kota kecil: pusat acak, titik menyebar normal di sekitarnya
+        int clusterCount = max(1, n / 1000);
+        uniform_int_distribution<int> coordinate(0, side);
+        vector<pair<int, int>> centers(clusterCount);
+        for (auto& c : centers) c = {coordinate(rng), coordinate(rng)};
+        uniform_int_distribution<int> pick(0, clusterCount - 1);
+        normal_distribution<double> spread(0.0, 400.0 * sqrt(1000.0) / 3);
+        for (int i = 0; i < n; i++) {
+            const auto& c = centers[pick(rng)];
+            int x = min(side, max(0, (int)(c.first + spread(rng))));
+            int y = min(side, max(0, (int)(c.second + spread(rng))));
+            table.add(x, y, string_view());
+        }
+    } else {
+        uniform_int_distribution<int> coordinate(0, side);
+        for (int i = 0; i < n; i++) {
+            int x = coordinate(rng);
+            int y = coordinate(rng);
+            table.add(x, y, string_view());
+        }
+    }
+    return table;
+}
+
+// FNV-1a atas offsets, targets dan weights CSR
+uint64_t graphHash(const CsrGraph& graph) {
+    uint64_t hash = fnv1a64((const unsigned char*)graph.offsets, sizeof(int32_t) * (graph.numNodes() + 1));
+    hash = fnv1a64((const unsigned char*)graph.targets, sizeof(int32_t) * graph.numEdges(), hash);
+    return fnv1a64((const unsigned char*)graph.weights, sizeof(Weight) * graph.numEdges(), hash);
+}
+
+double percentile(vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+void runConfiguration(const BenchConfig& config, const string& distribution, int n) {
+    char line[512];
+    
+    auto began = chrono::steady_clock::now();
+    LocationTable table = generatePoints(distribution, n, config.seed);
+    double generateSeconds = secondsSince(began);
+    
+    // Satu build per jumlah thread; speedup relatif terhadap build pertama dan graph_hash harus
+    // sama di semua baris (graph tidak bergantung pada jumlah thread)
+    unique_ptr<RoadNetwork> built;
+    double firstBuildSeconds = 0;
+    for (size_t r = 0; r < config.buildThreads.size(); r++) {
+        if (r > 0) {
+            built.reset();
+            table = generatePoints(distribution, n, config.seed);
+        }
+        began = chrono::steady_clock::now();
+        built.reset(new RoadNetwork(move(table), config.buildThreads[r]));
+        double buildSeconds = secondsSince(began);
+        if (r == 0) firstBuildSeconds = buildSeconds;
+        
+        snprintf(line, sizeof(line),
+                 "{\"bench\":\"build\",\"dist\":\"%s\",\"nodes\":%d,\"edges\":%d,\"seed\":%llu,\"kernel\":\"%s\","
+                 "\"threads\":%d,\"generate_s\":%.4f,\"build_s\":%.4f,\"neighbors_s\":%.4f,\"symmetrize_s\":%.4f,"
+                 "\"csr_s\":%.4f,\"speedup\":%.2f,\"edges_added\":%d,\"graph_hash\":\"%016llx\",\"peak_rss_kb\":%ld}",
+                 distribution.c_str(), n, built->graph.numEdges(), config.seed, distanceKernelKey(activeDistanceKernel()),
+                 built->buildTimings.threads, generateSeconds, buildSeconds, built->buildTimings.neighbors,
+                 built->buildTimings.symmetrize, built->buildTimings.compact,
+                 buildSeconds > 0 ? firstBuildSeconds / buildSeconds : 0.0, built->symmetrizeStats.added,
+                 (unsigned long long)graphHash(built->graph), peakRssKb());
+        cout << line << endl;
+    }
+    RoadNetwork& network = *built;
+    
+    // Pasangan query sama untuk semua mode agar latensinya bisa dibandingkan
+    mt19937_64 rng(config.seed + 1);
+    uniform_int_distribution<int> node(0, n - 1);
+    vector<pair<int, int>> pairs(config.queries);
+    for (auto& q : pairs) q = {node(rng), node(rng)};
+    
+    for (SearchMode mode : config.modes) {
+        network.searchMode = mode;
+        began = chrono::steady_clock::now();
+        if (!network.prepareSearchMode()) {
+            cerr << network.hierarchy.error() << endl;
+            continue;
+        }
+        double prepareSeconds = secondsSince(began);
+        
+        vector<double> latencies;
+        latencies.reserve(pairs.size());
+        long long settled = 0;
+        int reachable = 0;
+        began = chrono::steady_clock::now();
+        for (const auto& q : pairs) {
+            auto queryBegan = chrono::steady_clock::now();
+            RouteResult route = network.findRoute(q.first, q.second);
+            latencies.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - queryBegan).count());
+            settled += route.settledNodes;
+            if (!route.path.empty()) reachable++;
+        }
+        double totalSeconds = secondsSince(began);
+        sort(latencies.begin(), latencies.end());
+        
+        snprintf(line, sizeof(line),
+                 "{\"bench\":\"query\",\"dist\":\"%s\",\"nodes\":%d,\"mode\":\"%s\",\"queries\":%d,"
+                 "\"prepare_s\":%.4f,\"p50_us\":%.1f,\"p99_us\":%.1f,\"qps\":%.1f,\"settled_mean\":%.1f,"
+                 "\"reachable\":%d,\"peak_rss_kb\":%ld}",
+                 distribution.c_str(), n, searchModeKey(mode), (int)pairs.size(), prepareSeconds,
+                 percentile(latencies, 0.5), percentile(latencies, 0.99),
+                 totalSeconds > 0 ? pairs.size() / totalSeconds : 0.0,
+                 pairs.empty() ? 0.0 : (double)settled / pairs.size(), reachable, peakRssKb());
+        cout << line << endl;
+    }
+}
+
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    stringstream stream(text);
+    string item;
+    while (getline(stream, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--sizes" && i + 1 < argc) {
+            config.sizes.clear();
+            for (const string& size : splitList(argv[++i])) config.sizes.push_back(atoi(size.c_str()));
+        } else if (arg == "--dist" && i + 1 < argc) {
+            config.distributions = splitList(argv[++i]);
+        } else if (arg == "--modes" && i + 1 < argc) {
+            config.modes.clear();
+            for (const string& name : splitList(argv[++i])) {
+                SearchMode mode;
+                if (!parseSearchMode(name, mode)) {
+                    cerr << "Mode tidak dikenal: " << name << endl;
+                    return 1;
+                }
+                config.modes.push_back(mode);
+            }
+        } else if (arg == "--queries" && i + 1 < argc) {
+            config.queries = atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--build-threads" && i + 1 < argc) {
+            config.buildThreads.clear();
+            for (const string& count : splitList(argv[++i])) config.buildThreads.push_back(max(0, atoi(count.c_str())));
+            if (config.buildThreads.empty()) config.buildThreads.push_back(0);
+        } else if (arg == "--kernel" && i + 1 < argc) {
+            DistanceKernel kernel;
+            if (!parseDistanceKernel(argv[++i], kernel) || !setDistanceKernel(kernel)) {
+                cerr << "Kernel jarak tidak dikenal atau tidak didukung CPU ini: " << argv[i] << endl;
+                return 1;
+            }
+        } else {
+            cerr << "Argumen tidak dikenal: " << arg << endl;
+            return 1;
+        }
+    }
+    for (const string& distribution : config.distributions) {
+        if (distribution != "random" && distribution != "clustered") {
+            cerr << "Distribusi tidak dikenal: " << distribution << " (pilihan: random, clustered)" << endl;
+            return 1;
+        }
+    }
+    
+    int failures = 0;
+    for (const string& distribution : config.distributions) {
+        for (int n : config.sizes) {
+            if (n < 2) continue;
+            cerr << "Benchmark " << distribution << " " << n << " titik..." << endl;
+            pid_t child = fork();
+            if (child == 0) {
+                runConfiguration(config, distribution, n);
+                _exit(0);
+            }
+            int status = 0;
+            waitpid(child, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                cerr << "Benchmark " << distribution << " " << n << " gagal" << endl;
+                failures++;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// DIHASILKAN oleh `make builtin` (maps --generate-builtin) dari defaultLocations() di main2.cpp.
+// Jangan diedit manual; jalankan `make check-builtin` untuk memastikan isinya masih sama
+// dengan graph yang dibangun saat runtime.
+
+#include "embedded_graph.h"
+
+static const int32_t BUILTIN_XS[] = {
+    2070, 1810, 575, 370, 1625, 3095, 2515, 3915, 3860, 4470, 5780, 6650,
+    4505, 4620, 5080, 5790, 5400, 3630, 3825, 2910
+};
+
+static const int32_t BUILTIN_YS[] = {
+    2995, 3400, 2525, 2180, 1755, 1720, 685, 390, 730, 575, 1285, 1775,
+    1665, 2170, 2450, 3325, 3565, 3555, 2385, 2745
+};
+
+static const uint32_t BUILTIN_NAME_OFFSETS[] = {
+    0, 25, 47, 55, 83, 114, 140, 159, 180, 200, 219, 240,
+    268, 295, 321, 333, 350, 360, 383, 403, 425
+};
+
+static const char BUILTIN_NAMES[] =
+    "Pesantren Islam Al Irsyad"
+    "Penginapan Ummu Yasmin"
+    "Raff Kos"
+    "GCC Makmur Indonesia Project"
+    "Pesantren Islam Al Irsyad Putri"
+    "Penginapan Walisantri AMMA"
+    "Lapangan Desa Butuh"
+    "Geral Samsat Tengaran"
+    "SPBU PERTAMINA Butuh"
+    "Joglo Kebon Ndhelik"
+    "Lapangan Karang Duren"
+    "Kezia Grosir Ikan Hias Murah"
+    "Ponpes Nurul Islam Tengaran"
+    "PT Japfa Comfeed Indonesia"
+    "Amelia House"
+    "Musholla Arrahman"
+    "Iguana Kos"
+    "Rocket Chicken Tengaran"
+    "SPBU PERTAMINA Klero"
+    "Masjid Sabilul Khairat";
+
+static const int32_t BUILTIN_CSR_OFFSETS[] = {
+    0, 7, 13, 17, 21, 27, 36, 41, 46, 51, 57, 62,
+    65, 73, 82, 89, 93, 98, 104, 111, 116
+};
+
+static const int32_t BUILTIN_CSR_TARGETS[] = {
+    1, 19, 4, 2, 5, 3, 17, 0, 19, 2, 4, 17,
+    3, 3, 4, 1, 0, 2, 4, 0, 1, 2, 0, 3,
+    6, 5, 1, 18, 19, 6, 8, 12, 0, 4, 7, 13,
+    5, 8, 4, 7, 9, 8, 9, 12, 6, 5, 7, 9,
+    12, 5, 6, 7, 8, 12, 10, 13, 6, 11, 12, 14,
+    13, 9, 10, 14, 15, 13, 14, 18, 9, 8, 5, 7,
+    10, 12, 14, 18, 10, 5, 9, 15, 16, 17, 13, 12,
+    15, 16, 18, 10, 11, 16, 14, 13, 11, 15, 14, 13,
+    17, 18, 19, 18, 0, 13, 16, 1, 13, 19, 5, 12,
+    17, 14, 16, 0, 18, 5, 17, 1
+};
+
+static const Weight BUILTIN_CSR_WEIGHTS[] = {
+    123206, 224362, 337262, 401188, 418797, 482628, 424312, 123206, 327742, 387470, 423775, 467607,
+    483155, 102735, 333331, 387470, 401188, 102735, 339202, 482628, 483155, 333331, 337262, 339202,
+    356291, 376427, 423775, 252796, 266640, 303727, 320289, 361235, 418797, 376427, 399991, 407042,
+    303727, 344513, 356291, 366270, 501272, 88171, 149765, 359653, 366270, 399991, 88171, 161122,
+    290788, 320289, 344513, 149765, 161122, 279184, 381449, 410122, 501272, 255616, 340588, 347936,
+    373517, 381449, 255616, 437492, 453785, 132590, 249104, 253530, 279184, 290788, 361235, 359653,
+    340588, 132590, 137860, 210831, 373517, 407042, 410122, 420879, 409154, 435826, 137860, 249104,
+    288466, 296963, 321711, 347936, 437492, 117230, 288466, 420879, 453785, 117230, 296963, 409154,
+    453127, 503808, 277438, 303652, 424312, 435826, 453127, 467607, 210831, 251718, 252796, 253530,
+    303652, 321711, 503808, 224362, 251718, 266640, 277438, 327742
+};
+
+static const int32_t BUILTIN_COMPONENT_ROOTS[] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const int32_t BUILTIN_COMPONENT_SIZES[] = {
+    20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20, 20,
+    20, 20, 20, 20, 20, 20, 20, 20
+};
+
+static const int32_t BUILTIN_SCREEN_XS[] = {
+    565, 494, 156, 100, 444, 846, 687, 1071, 1056, 1223, 1582, 1820,
+    1232, 1264, 1390, 1584, 1477, 993, 1046, 796
+};
+
+static const int32_t BUILTIN_SCREEN_YS[] = {
+    258, 146, 389, 484, 602, 612, 899, 980, 886, 929, 732, 597,
+    627, 487, 409, 167, 100, 103, 427, 328
+};
+
+inline const EmbeddedGraph& builtinGraph() {
+    static const EmbeddedGraph graph = {
+        20, 116,
+        BUILTIN_XS, BUILTIN_YS, BUILTIN_NAME_OFFSETS, BUILTIN_NAMES,
+        BUILTIN_CSR_OFFSETS, BUILTIN_CSR_TARGETS, BUILTIN_CSR_WEIGHTS,
+        BUILTIN_COMPONENT_ROOTS, BUILTIN_COMPONENT_SIZES,
+        21, 0,
+        {0.27388535031847133, 0.27716535433070866, -1, -8, 1080, BUILTIN_SCREEN_XS, BUILTIN_SCREEN_YS},
+    };
+    return graph;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+
+#include "graph_types.h"
+
+// Komponen terhubung graph dengan union-find (union by size + path halving). Setelah build
+// semua simpul menunjuk langsung ke akarnya, jadi connected() cukup membaca dua entri dan
+// aman dipanggil dari banyak thread selama tidak ada pembaruan yang berjalan.
+//
+// Pembaruan inkremental: edge baru cukup unite(); edge yang hilang tidak bisa dibatalkan di
+// union-find, jadi komponen menjadi "kasar" (mungkin menggabungkan komponen yang sebenarnya
+// sudah terpisah). Penolakan query tetap benar karena label berbeda tetap berarti tidak
+// terhubung; isExact() memberi tahu kapan build() perlu diulang untuk ukuran yang tepat.
+class ComponentIndex {
+private:
+    vector<int> parent;
+    vector<int> size;
+    bool exact = true;
+    
+    // Akar tanpa mengubah array (dipakai query yang bisa berjalan paralel)
+    int root(int v) const {
+        while (parent[v] != v) v = parent[v];
+        return v;
+    }
+    
+    int findCompress(int v) {
+        while (parent[v] != v) {
+            parent[v] = parent[parent[v]];
+            v = parent[v];
+        }
+        return v;
+    }
+    
+public:
+    void build(const CsrGraph& graph) {
+        int n = graph.numNodes();
+        reset(n);
+        for (int u = 0; u < n; u++) {
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                unite(u, graph.targets[e]);
+            }
+        }
+        flatten();
+    }
+    
+    // Pakai hasil yang sudah dihitung sebelumnya (misalnya graph bawaan): akar tiap simpul yang
+    // sudah diratakan dan ukuran komponennya, cukup disalin tanpa union-find
+    void load(int n, const int32_t* roots, const int32_t* sizes) {
+        parent.assign(roots, roots + n);
+        size.assign(sizes, sizes + n);
+        exact = true;
+    }
+    
+    // Semua simpul menjadi komponen sendiri; lanjutkan dengan unite() lalu flatten()
+    void reset(int n) {
+        parent.resize(n);
+        iota(parent.begin(), parent.end(), 0);
+        size.assign(n, 1);
+        exact = true;
+    }
+    
+    void unite(int a, int b) {
+        a = findCompress(a);
+        b = findCompress(b);
+        if (a == b) return;
+        if (size[a] < size[b]) swap(a, b);
+        parent[b] = a;
+        size[a] += size[b];
+    }
+    
+    // Arahkan setiap simpul langsung ke akarnya
+    void flatten() {
+        for (int v = 0; v < (int)parent.size(); v++) {
+            parent[v] = findCompress(v);
+        }
+    }
+    
+    int addNode() {
+        parent.push_back(parent.size());
+        size.push_back(1);
+        return parent.size() - 1;
+    }
+    
+    // Dipanggil saat edge hilang: hasil tetap aman untuk penolakan, tetapi ukurannya kasar
+    void markInexact() { exact = false; }
+    bool isExact() const { return exact; }
+    
+    bool connected(int a, int b) const { return root(a) == root(b); }
+    int componentOf(int v) const { return root(v); }
+    int componentSize(int v) const { return size[root(v)]; }
+};
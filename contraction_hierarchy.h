@@ -0,0 +1,433 @@
+#pragma once
+
+#include <algorithm>
+#include <queue>
+
+#include "graph_types.h"
+#include "search_context.h"
+
+// Contraction Hierarchies: simpul dikontraksi satu per satu (urutan berdasarkan edge difference),
+// jalan pintas (shortcut) ditambahkan bila tidak ada jalur saksi yang sama pendeknya. Query cukup
+// menelusuri edge "naik" (ke simpul dengan rank lebih tinggi) dari kedua ujung.
+class ContractionHierarchy {
+public:
+    // Array mentah satu graph naik, untuk disimpan ke / dibaca dari file graph. Untuk shortcut,
+    // middle = simpul yang dilewati, firstHalf = indeks edge from -> middle di backwardUp dan
+    // secondHalf = indeks edge middle -> to di forwardUp; ketiganya -1 untuk edge asli.
+    struct UpwardArrays {
+        const int32_t* offsets;
+        const int32_t* targets;
+        const Weight* weights;
+        const int32_t* middle;
+        const int32_t* firstHalf;
+        const int32_t* secondHalf;
+    };
+    
+private:
+    // Edge graph kerja. Bobot shortcut diperiksa terhadap batas Weight sebelum disimpan (build
+    // gagal jika terlampaui, tidak pernah dipotong). firstPos/secondPos = posisi kedua setengah
+    // shortcut di daftar masuk/keluar middle saat middle dikontraksi.
+    struct ChArc {
+        int to;
+        Weight weight;
+        int middle; // Simpul yang dilewati shortcut, -1 untuk edge asli
+        int firstPos, secondPos;
+    };
+    
+    struct Shortcut {
+        int from, to;
+        PathLength weight;
+        int firstPos, secondPos;
+    };
+    
+    // Graph naik dalam format CSR; middle dan kedua setengah shortcut sejajar dengan targets/weights
+    struct UpwardGraph {
+        CsrGraph arcs;
+        const int32_t* middle = nullptr;
+        const int32_t* firstHalf = nullptr;
+        const int32_t* secondHalf = nullptr;
+        vector<int32_t> middleStorage, firstStorage, secondStorage;
+        
+        void build(const vector<vector<ChArc>>& lists) {
+            vector<vector<Edge>> edges(lists.size());
+            middleStorage.clear();
+            for (size_t u = 0; u < lists.size(); u++) {
+                for (const ChArc& a : lists[u]) {
+                    edges[u].push_back(Edge(a.to, a.weight));
+                    middleStorage.push_back(a.middle);
+                }
+            }
+            arcs.build(edges);
+            middle = middleStorage.data();
+        }
+        
+        // Indeks setengah shortcut baru bisa dihitung setelah kedua graph naik tersusun
+        void linkHalves(const vector<vector<ChArc>>& lists, const UpwardGraph& forward, const UpwardGraph& backward) {
+            firstStorage.assign(arcs.numEdges(), -1);
+            secondStorage.assign(arcs.numEdges(), -1);
+            for (size_t u = 0; u < lists.size(); u++) {
+                int e = arcs.begin(u);
+                for (const ChArc& a : lists[u]) {
+                    if (a.middle != -1) {
+                        firstStorage[e] = backward.arcs.begin(a.middle) + a.firstPos;
+                        secondStorage[e] = forward.arcs.begin(a.middle) + a.secondPos;
+                    }
+                    e++;
+                }
+            }
+            firstHalf = firstStorage.data();
+            secondHalf = secondStorage.data();
+        }
+        
+        void attach(int n, const UpwardArrays& arrays) {
+            arcs.attach(n, arrays.offsets, arrays.targets, arrays.weights);
+            middleStorage.clear();
+            firstStorage.clear();
+            secondStorage.clear();
+            middle = arrays.middle;
+            firstHalf = arrays.firstHalf;
+            secondHalf = arrays.secondHalf;
+        }
+        
+        UpwardArrays arrays() const {
+            return {arcs.offsets, arcs.targets, arcs.weights, middle, firstHalf, secondHalf};
+        }
+    };
+    
+    // Pencarian saksi dibatasi jumlah simpul yang diproses dan jumlah edge (hop) dari asal.
+    // Batas yang terlalu kecil hanya menambah shortcut yang tidak perlu, hasil query tetap benar.
+    static const int WITNESS_SETTLE_LIMIT = 200; // Saat kontraksi sungguhan
+    static const int WITNESS_HOP_LIMIT = 6;
+    static const int ESTIMATE_SETTLE_LIMIT = 40; // Saat hanya memperkirakan prioritas
+    static const int ESTIMATE_HOP_LIMIT = 3;
+    // Tetangga simpul yang baru dikontraksi dengan derajat keluar sampai batas ini disimulasikan
+    // ulang (murah); yang lebih padat memakai edge difference lama sampai diambil dari antrian
+    static const int RESIMULATE_DEGREE_LIMIT = 16;
+    
+    int numNodes = 0;
+    vector<int> rank;
+    UpwardGraph forwardUp;  // Edge u -> v dengan rank[v] > rank[u], disimpan di u
+    UpwardGraph backwardUp; // Edge v -> u asli dengan rank[v] > rank[u], disimpan di u sebagai (v)
+    int shortcutCount = 0;
+    bool built = false;
+    string errorMessage;
+    
+    // Graph kerja selama kontraksi; hanya berisi edge antar simpul yang belum dikontraksi
+    vector<vector<ChArc>> outArcs, inArcs;
+    vector<bool> contracted;
+    vector<int> contractedNeighbors;
+    vector<int> level;           // Kedalaman hierarki, agar kontraksi menyebar merata
+    vector<int> edgeDifference;  // Hasil simulasi kontraksi terakhir (shortcut - derajat)
+    vector<int> currentPriority; // Untuk membuang entri usang di antrian prioritas
+    bool weightOverflow = false;
+    SearchContext witness;
+    vector<unsigned> targetMark; // == targetRound: target pencarian saksi yang sedang berjalan
+    unsigned targetRound = 0;
+    
+    static void upsertArc(vector<ChArc>& list, const ChArc& arc) {
+        for (ChArc& a : list) {
+            if (a.to == arc.to) {
+                if (arc.weight < a.weight) a = arc;
+                return;
+            }
+        }
+        list.push_back(arc);
+    }
+    
+    static void removeArc(vector<ChArc>& list, int to) {
+        for (size_t i = 0; i < list.size(); i++) {
+            if (list[i].to == to) {
+                list[i] = list.back();
+                list.pop_back();
+                return;
+            }
+        }
+    }
+    
+    // Dijkstra terbatas dari source di graph kerja tanpa melewati simpul via; label = jumlah hop.
+    // Berhenti setelah semua tetangga keluar via (target shortcut) diproses.
+    void witnessSearch(int source, int via, PathLength maxDistance, int settleLimit, int hopLimit) {
+        witness.prepare(numNodes);
+        witness.reach(source, 0, -1);
+        witness.setLabel(source, 0);
+        targetRound++;
+        int targetsLeft = 0;
+        for (const ChArc& out : outArcs[via]) {
+            if (out.to != source && targetMark[out.to] != targetRound) {
+                targetMark[out.to] = targetRound;
+                targetsLeft++;
+            }
+        }
+        int settledNodes = 0;
+        while (!witness.heapEmpty() && targetsLeft > 0) {
+            int u = witness.popMin();
+            if (witness.settled(u)) continue;
+            witness.settle(u);
+            PathLength du = witness.distance(u);
+            if (du > maxDistance || ++settledNodes > settleLimit) break;
+            if (targetMark[u] == targetRound) targetsLeft--;
+            int hops = witness.label(u);
+            if (hops >= hopLimit) continue;
+            for (const ChArc& a : outArcs[u]) {
+                if (a.to == via) continue;
+                PathLength nd = du + a.weight;
+                if (!witness.settled(a.to) && nd < witness.distance(a.to)) {
+                    witness.reach(a.to, nd, u);
+                    witness.setLabel(a.to, hops + 1);
+                }
+            }
+        }
+    }
+    
+    // Kontraksi v (atau simulasi saja jika apply = false); kembalikan jumlah shortcut
+    int contractNode(int v, bool apply) {
+        int added = 0;
+        PathLength maxOut = 0;
+        for (const ChArc& out : outArcs[v]) maxOut = max(maxOut, (PathLength)out.weight);
+        vector<Shortcut> pending;
+        const vector<ChArc>& ins = inArcs[v];
+        const vector<ChArc>& outs = outArcs[v];
+        for (size_t i = 0; i < ins.size(); i++) {
+            int u = ins[i].to;
+            witnessSearch(u, v, ins[i].weight + maxOut, apply ? WITNESS_SETTLE_LIMIT : ESTIMATE_SETTLE_LIMIT,
+                          apply ? WITNESS_HOP_LIMIT : ESTIMATE_HOP_LIMIT);
+            for (size_t j = 0; j < outs.size(); j++) {
+                int w = outs[j].to;
+                if (w == u) continue;
+                PathLength viaV = (PathLength)ins[i].weight + outs[j].weight;
+                if (witness.distance(w) > viaV) {
+                    added++;
+                    if (apply) pending.push_back({u, w, viaV, (int)i, (int)j});
+                }
+            }
+        }
+        for (const Shortcut& s : pending) {
+            // Shortcut lebih panjang dari batas Weight (~16.700 km) tidak bisa disimpan: build gagal
+            if (s.weight > numeric_limits<Weight>::max()) {
+                weightOverflow = true;
+                break;
+            }
+            upsertArc(outArcs[s.from], {s.to, (Weight)s.weight, v, s.firstPos, s.secondPos});
+            upsertArc(inArcs[s.to], {s.from, (Weight)s.weight, v, s.firstPos, s.secondPos});
+        }
+        return added;
+    }
+    
+    // Prioritas dari edge difference simulasi terakhir, ditambah jumlah tetangga yang sudah
+    // dikontraksi dan kedalaman hierarki agar simpul yang dikontraksi tersebar merata
+    int estimatedPriority(int v) const {
+        return edgeDifference[v] + contractedNeighbors[v] + level[v];
+    }
+    
+    // Prioritas lengkap: simulasikan kontraksi v untuk memperbarui edge difference-nya
+    int priority(int v) {
+        edgeDifference[v] = contractNode(v, false) - (int)(outArcs[v].size() + inArcs[v].size());
+        return estimatedPriority(v);
+    }
+    
+    // Pecah edge hierarki e milik graph g (from -> to) menjadi simpul-simpul asli, tanpa from
+    void unpackArc(int from, int to, const UpwardGraph& g, int e, vector<int>& path) const {
+        int middle = g.middle[e];
+        if (middle == -1) {
+            path.push_back(to);
+            return;
+        }
+        // from -> middle adalah edge turun dari sudut pandang middle (tersimpan di backwardUp[middle]),
+        // middle -> to adalah edge naik dari middle (tersimpan di forwardUp[middle])
+        unpackArc(from, middle, backwardUp, g.firstHalf[e], path);
+        unpackArc(middle, to, forwardUp, g.secondHalf[e], path);
+    }
+    
+public:
+    // Gagal (false, lihat error()) jika ada shortcut yang bobotnya melebihi batas Weight
+    bool build(const CsrGraph& graph) {
+        numNodes = graph.numNodes();
+        outArcs.assign(numNodes, vector<ChArc>());
+        inArcs.assign(numNodes, vector<ChArc>());
+        for (int u = 0; u < numNodes; u++) {
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.targets[e];
+                upsertArc(outArcs[u], {v, graph.weights[e], -1, -1, -1});
+                upsertArc(inArcs[v], {u, graph.weights[e], -1, -1, -1});
+            }
+        }
+        contracted.assign(numNodes, false);
+        contractedNeighbors.assign(numNodes, 0);
+        level.assign(numNodes, 0);
+        edgeDifference.assign(numNodes, 0);
+        currentPriority.assign(numNodes, 0);
+        rank.assign(numNodes, 0);
+        weightOverflow = false;
+        targetMark.assign(numNodes, 0);
+        targetRound = 0;
+        errorMessage.clear();
+        int originalArcs = graph.numEdges();
+        
+        // Antrian prioritas dengan lazy update: prioritas dihitung ulang saat diambil
+        priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> order;
+        for (int v = 0; v < numNodes; v++) {
+            currentPriority[v] = priority(v);
+            order.push({currentPriority[v], v});
+        }
+        
+        vector<vector<ChArc>> upLists(numNodes), downLists(numNodes);
+        int nextRank = 0;
+        while (!order.empty()) {
+            int v = order.top().second;
+            int queued = order.top().first;
+            order.pop();
+            if (contracted[v] || queued != currentPriority[v]) continue;
+            
+            int current = priority(v);
+            if (!order.empty() && current > order.top().first) {
+                currentPriority[v] = current;
+                order.push({current, v});
+                continue;
+            }
+            
+            contractNode(v, true);
+            if (weightOverflow) {
+                *this = ContractionHierarchy();
+                errorMessage = "Contraction Hierarchies tidak bisa dibangun: shortcut melebihi batas bobot";
+                return false;
+            }
+            contracted[v] = true;
+            rank[v] = nextRank++;
+            
+            // Semua edge v tersisa menuju simpul yang belum dikontraksi, jadi menjadi edge naik milik
+            // v; posisinya di daftar ini yang dirujuk firstPos/secondPos shortcut lewat v
+            upLists[v] = move(outArcs[v]);
+            downLists[v] = move(inArcs[v]);
+            vector<ChArc>().swap(outArcs[v]);
+            vector<ChArc>().swap(inArcs[v]);
+            
+            // Buang v dari graph kerja lalu perbarui prioritas tetangganya. Nilai pasti tetangga
+            // yang padat baru dihitung ulang saat tetangga itu diambil dari antrian.
+            vector<int> neighbors;
+            for (const ChArc& a : upLists[v]) {
+                removeArc(inArcs[a.to], v);
+                neighbors.push_back(a.to);
+            }
+            for (const ChArc& a : downLists[v]) {
+                removeArc(outArcs[a.to], v);
+                neighbors.push_back(a.to);
+            }
+            sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            for (int w : neighbors) {
+                contractedNeighbors[w]++;
+                level[w] = max(level[w], level[v] + 1);
+                bool cheap = (int)outArcs[w].size() <= RESIMULATE_DEGREE_LIMIT;
+                currentPriority[w] = cheap ? priority(w) : estimatedPriority(w);
+                order.push({currentPriority[w], w});
+            }
+        }
+        
+        forwardUp.build(upLists);
+        backwardUp.build(downLists);
+        forwardUp.linkHalves(upLists, forwardUp, backwardUp);
+        backwardUp.linkHalves(downLists, forwardUp, backwardUp);
+        shortcutCount = forwardUp.arcs.numEdges() + backwardUp.arcs.numEdges() - originalArcs;
+        
+        vector<vector<ChArc>>().swap(outArcs);
+        vector<vector<ChArc>>().swap(inArcs);
+        built = true;
+        return true;
+    }
+    
+    // Pakai hasil preprocessing yang sudah ada (misalnya dari file graph) tanpa kontraksi ulang
+    void attach(int nodes, int shortcuts, const UpwardArrays& forward, const UpwardArrays& backward) {
+        numNodes = nodes;
+        forwardUp.attach(nodes, forward);
+        backwardUp.attach(nodes, backward);
+        shortcutCount = shortcuts;
+        built = true;
+    }
+    
+    bool isBuilt() const { return built; }
+    const string& error() const { return errorMessage; }
+    
+    // Buang hasil preprocessing (graph berubah); build() berikutnya membangun ulang
+    void reset() { *this = ContractionHierarchy(); }
+    int shortcuts() const { return shortcutCount; }
+    UpwardArrays forwardArrays() const { return forwardUp.arrays(); }
+    UpwardArrays backwardArrays() const { return backwardUp.arrays(); }
+    
+    // Query dua arah yang hanya naik hierarki; jalur hasilnya sudah dipecah ke simpul asli
+    RouteResult query(int start, int end, SearchContext& forward, SearchContext& backward) const {
+        forward.prepare(numNodes);
+        backward.prepare(numNodes);
+        forward.reach(start, 0, -1);
+        backward.reach(end, 0, -1);
+        
+        PathLength best = UNREACHED;
+        int meeting = -1;
+        int settledNodes = 0;
+        
+        // Kedua arah berjalan sampai key minimumnya tidak lagi lebih kecil dari jarak terbaik
+        while (true) {
+            bool forwardOpen = !forward.heapEmpty() && forward.minKey() < best;
+            bool backwardOpen = !backward.heapEmpty() && backward.minKey() < best;
+            if (!forwardOpen && !backwardOpen) break;
+            
+            bool isForward = forwardOpen && (!backwardOpen || forward.minKey() <= backward.minKey());
+            SearchContext& self = isForward ? forward : backward;
+            const SearchContext& other = isForward ? backward : forward;
+            const CsrGraph& up = isForward ? forwardUp.arcs : backwardUp.arcs;
+            const CsrGraph& down = isForward ? backwardUp.arcs : forwardUp.arcs;
+            
+            int u = self.popMin();
+            if (self.settled(u)) continue;
+            self.settle(u);
+            settledNodes++;
+            
+            PathLength du = self.distance(u);
+            if (other.reached(u) && du + other.distance(u) < best) {
+                best = du + other.distance(u);
+                meeting = u;
+            }
+            
+            // Stall-on-demand: jika simpul lebih tinggi sudah memberi jarak lebih pendek ke u,
+            // u pasti bukan bagian jalur terpendek naik, jadi edge-nya tidak perlu direlaksasi
+            bool stalled = false;
+            for (int e = down.begin(u); e < down.end(u) && !stalled; e++) {
+                stalled = self.distance(down.targets[e]) + down.weights[e] < du;
+            }
+            if (stalled) continue;
+            
+            self.scanned(up.degree(u));
+            for (int e = up.begin(u); e < up.end(u); e++) {
+                int v = up.targets[e];
+                PathLength nd = du + up.weights[e];
+                if (!self.settled(v) && nd < self.distance(v)) {
+                    self.reach(v, nd, u);
+                    self.setLabel(v, e); // Edge yang dipakai, agar jalur bisa dipecah tanpa mencari
+                }
+            }
+        }
+        
+        RouteResult result;
+        result.settledNodes = settledNodes;
+        result.counters = forward.counters;
+        result.counters += backward.counters;
+        if (meeting == -1) return result;
+        result.distance = toUnits(best);
+        
+        // Rantai simpul hierarki start -> meeting lalu meeting -> end
+        vector<int> upChain;
+        for (int current = meeting; current != -1; current = forward.previous(current)) {
+            upChain.push_back(current);
+        }
+        reverse(upChain.begin(), upChain.end());
+        
+        result.path.push_back(start);
+        for (size_t i = 0; i + 1 < upChain.size(); i++) {
+            unpackArc(upChain[i], upChain[i + 1], forwardUp, forward.label(upChain[i + 1]), result.path);
+        }
+        for (int current = meeting; backward.previous(current) != -1; current = backward.previous(current)) {
+            // Edge asli current -> next tersimpan di backwardUp[next] sebagai (current)
+            unpackArc(current, backward.previous(current), backwardUp, backward.label(current), result.path);
+        }
+        return result;
+    }
+};
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define MAPS_X86_KERNELS 1
+#else
+#define MAPS_X86_KERNELS 0
+#endif
+
+#include "graph_types.h"
+
+// Jarak Euclidean dari satu titik ke banyak titik sekaligus, langsung dari array koordinat
+// LocationTable (xs, ys terpisah). Versi SSE2/AVX2 dipilih saat runtime sesuai CPU; hasilnya
+// identik bit-per-bit dengan versi skalar (selisih int -> double, kuadrat, jumlah, sqrt, tanpa
+// FMA), jadi jalur dan urutan tetangga tidak bergantung pada CPU.
+
+enum DistanceKernel {
+    KERNEL_SCALAR,
+    KERNEL_SSE2,
+    KERNEL_AVX2,
+    DISTANCE_KERNEL_COUNT
+};
+
+inline const char* distanceKernelKey(DistanceKernel kernel) {
+    switch (kernel) {
+        case KERNEL_SCALAR: return "scalar";
+        case KERNEL_SSE2: return "sse2";
+        case KERNEL_AVX2: return "avx2";
+        default: return "?";
+    }
+}
+
+inline bool parseDistanceKernel(const string& key, DistanceKernel& kernel) {
+    for (int k = 0; k < DISTANCE_KERNEL_COUNT; k++) {
+        if (key == distanceKernelKey((DistanceKernel)k)) {
+            kernel = (DistanceKernel)k;
+            return true;
+        }
+    }
+    return false;
+}
+
+inline bool distanceKernelSupported(DistanceKernel kernel) {
+#if MAPS_X86_KERNELS
+    switch (kernel) {
+        case KERNEL_SCALAR: return true;
+        case KERNEL_SSE2: return __builtin_cpu_supports("sse2");
+        case KERNEL_AVX2: return __builtin_cpu_supports("avx2");
+        default: return false;
+    }
+#else
+    return kernel == KERNEL_SCALAR;
+#endif
+}
+
+inline DistanceKernel& activeDistanceKernelSlot() {
+    static DistanceKernel kernel = distanceKernelSupported(KERNEL_AVX2) ? KERNEL_AVX2
+                                 : distanceKernelSupported(KERNEL_SSE2) ? KERNEL_SSE2 : KERNEL_SCALAR;
+    return kernel;
+}
+
+inline DistanceKernel activeDistanceKernel() { return activeDistanceKernelSlot(); }
+
+// Paksa kernel tertentu (misalnya untuk benchmark); false jika CPU tidak mendukungnya.
+// Panggil sebelum pencarian paralel dimulai.
+inline bool setDistanceKernel(DistanceKernel kernel) {
+    if (!distanceKernelSupported(kernel)) return false;
+    activeDistanceKernelSlot() = kernel;
+    return true;
+}
+
+inline double pointDistance(int x, int y, int px, int py) {
+    double dx = x - px;
+    double dy = y - py;
+    return sqrt(dx * dx + dy * dy);
+}
+
+#if MAPS_X86_KERNELS
+__attribute__((target("sse2")))
+inline void distancesSse2(int x, int y, const int32_t* xs, const int32_t* ys, const int32_t* indices,
+                          int count, double* out) {
+    __m128i qx = _mm_set1_epi32(x), qy = _mm_set1_epi32(y);
+    int k = 0;
+    for (; k + 2 <= count; k += 2) {
+        __m128i px, py;
+        if (indices) {
+            px = _mm_setr_epi32(xs[indices[k]], xs[indices[k + 1]], 0, 0);
+            py = _mm_setr_epi32(ys[indices[k]], ys[indices[k + 1]], 0, 0);
+        } else {
+            px = _mm_loadl_epi64((const __m128i*)(xs + k));
+            py = _mm_loadl_epi64((const __m128i*)(ys + k));
+        }
+        __m128d dx = _mm_cvtepi32_pd(_mm_sub_epi32(qx, px));
+        __m128d dy = _mm_cvtepi32_pd(_mm_sub_epi32(qy, py));
+        _mm_storeu_pd(out + k, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+    }
+    for (; k < count; k++) {
+        int j = indices ? indices[k] : k;
+        out[k] = pointDistance(x, y, xs[j], ys[j]);
+    }
+}
+
+__attribute__((target("avx2")))
+inline void distancesAvx2(int x, int y, const int32_t* xs, const int32_t* ys, const int32_t* indices,
+                          int count, double* out) {
+    __m128i qx = _mm_set1_epi32(x), qy = _mm_set1_epi32(y);
+    int k = 0;
+    for (; k + 4 <= count; k += 4) {
+        __m128i px, py;
+        if (indices) {
+            __m128i index = _mm_loadu_si128((const __m128i*)(indices + k));
+            px = _mm_i32gather_epi32((const int*)xs, index, 4);
+            py = _mm_i32gather_epi32((const int*)ys, index, 4);
+        } else {
+            px = _mm_loadu_si128((const __m128i*)(xs + k));
+            py = _mm_loadu_si128((const __m128i*)(ys + k));
+        }
+        __m256d dx = _mm256_cvtepi32_pd(_mm_sub_epi32(qx, px));
+        __m256d dy = _mm256_cvtepi32_pd(_mm_sub_epi32(qy, py));
+        _mm256_storeu_pd(out + k, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(dx, dx), _mm256_mul_pd(dy, dy))));
+    }
+    for (; k < count; k++) {
+        int j = indices ? indices[k] : k;
+        out[k] = pointDistance(x, y, xs[j], ys[j]);
+    }
+}
+#endif
+
+// out[k] = jarak (x, y) ke titik indices[k], atau ke titik k jika indices == nullptr
+inline void distancesFrom(int x, int y, const int32_t* xs, const int32_t* ys, const int32_t* indices,
+                          int count, double* out) {
+#if MAPS_X86_KERNELS
+    switch (activeDistanceKernel()) {
+        case KERNEL_AVX2: distancesAvx2(x, y, xs, ys, indices, count, out); return;
+        case KERNEL_SSE2: distancesSse2(x, y, xs, ys, indices, count, out); return;
+        default: break;
+    }
+#endif
+    for (int k = 0; k < count; k++) {
+        int j = indices ? indices[k] : k;
+        out[k] = pointDistance(x, y, xs[j], ys[j]);
+    }
+}
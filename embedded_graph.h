@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <ostream>
+
+#include "graph_types.h"
+
+// Skala dan offset tampilan BGI: peta dipusatkan di jendela dengan margin 100 piksel. xs/ys
+// (boleh null) berisi koordinat layar per lokasi yang sudah dihitung sebelumnya.
+struct ScreenLayout {
+    double scaleX = 0.08, scaleY = 0.08;
+    int offsetX = 50, offsetY = 50;
+    int windowHeight = 1080;
+    const int32_t* xs = nullptr;
+    const int32_t* ys = nullptr;
+    
+    int toScreenX(int worldX) const { return (int)(worldX * scaleX) + offsetX; }
+    int toScreenY(int worldY) const { return windowHeight - ((int)(worldY * scaleY) + offsetY); }
+    
+    static ScreenLayout fit(const LocationTable& locations, int windowWidth, int windowHeight) {
+        ScreenLayout layout;
+        layout.windowHeight = windowHeight;
+        if (locations.size() == 0) return layout;
+        
+        // Hitung bounding box lokasi
+        int minX = locations.xs[0], maxX = locations.xs[0];
+        int minY = locations.ys[0], maxY = locations.ys[0];
+        for (int i = 0; i < locations.size(); i++) {
+            minX = min(minX, locations.xs[i]);
+            maxX = max(maxX, locations.xs[i]);
+            minY = min(minY, locations.ys[i]);
+            maxY = max(maxY, locations.ys[i]);
+        }
+        int mapWidth = max(1, maxX - minX);
+        int mapHeight = max(1, maxY - minY);
+        layout.scaleX = (windowWidth - 200.0) / mapWidth;
+        layout.scaleY = (windowHeight - 200.0) / mapHeight;
+        // Offset agar peta di tengah
+        layout.offsetX = (windowWidth - (int)(mapWidth * layout.scaleX)) / 2 - (int)(minX * layout.scaleX);
+        layout.offsetY = (windowHeight - (int)(mapHeight * layout.scaleY)) / 2 - (int)(minY * layout.scaleY);
+        return layout;
+    }
+};
+
+// Graph lengkap dalam tabel statis yang dikompilasi ke program (lihat builtin_graph.h): lokasi,
+// CSR, komponen, statistik symmetrize dan tata letak layar. RoadNetwork memakainya langsung
+// lewat attach, seperti file graph yang di-mmap, tanpa buildGraph.
+struct EmbeddedGraph {
+    int nodeCount;
+    int edgeCount;
+    const int32_t* xs;
+    const int32_t* ys;
+    const uint32_t* nameOffsets;
+    const char* names;
+    const int32_t* offsets;
+    const int32_t* targets;
+    const Weight* weights;
+    const int32_t* componentRoots; // Akar komponen tiap simpul (sudah diratakan)
+    const int32_t* componentSizes; // Ukuran komponen tiap simpul
+    int reverseArcs;
+    int duplicateArcs;
+    ScreenLayout screen;
+};
+
+// Tulis array sebagai initializer C++, 12 angka per baris
+template <typename T>
+void writeEmbeddedArray(ostream& out, const char* type, const char* name, const T* data, size_t count) {
+    out << "static const " << type << " " << name << "[] = {";
+    for (size_t i = 0; i < count; i++) {
+        out << (i % 12 == 0 ? "\n    " : " ") << +data[i] << (i + 1 < count ? "," : "");
+    }
+    out << "\n};\n\n";
+}
+
+// Isi builtin_graph.h: tabel statis untuk graph yang sudah dibangun plus fungsi builtinGraph().
+// roots/sizes adalah hasil ComponentIndex per simpul.
+inline void writeEmbeddedGraph(ostream& out, const LocationTable& locations, const CsrGraph& graph,
+                               const vector<int32_t>& roots, const vector<int32_t>& sizes, int reverseArcs,
+                               int duplicateArcs, const ScreenLayout& screen, const vector<int32_t>& screenXs,
+                               const vector<int32_t>& screenYs) {
+    int n = locations.size();
+    out << "#pragma once\n\n"
+        << "// DIHASILKAN oleh `make builtin` (maps --generate-builtin) dari defaultLocations() di main2.cpp.\n"
+        << "// Jangan diedit manual; jalankan `make check-builtin` untuk memastikan isinya masih sama\n"
+        << "// dengan graph yang dibangun saat runtime.\n\n"
+        << "#include \"embedded_graph.h\"\n\n";
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_XS", locations.xs, n);
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_YS", locations.ys, n);
+    writeEmbeddedArray(out, "uint32_t", "BUILTIN_NAME_OFFSETS", locations.nameOffsets, n + 1);
+    
+    // Nama sebagai string literal; byte di luar ASCII cetak ditulis sebagai escape oktal
+    out << "static const char BUILTIN_NAMES[] =";
+    for (int i = 0; i < n; i++) {
+        out << "\n    \"";
+        for (char c : locations.name(i)) {
+            unsigned char u = (unsigned char)c;
+            if (c == '"' || c == '\\') {
+                out << '\\' << c;
+            } else if (u < 0x20 || u >= 0x7f || c == '?') {
+                const char* digits = "01234567";
+                out << '\\' << digits[u >> 6] << digits[(u >> 3) & 7] << digits[u & 7];
+            } else {
+                out << c;
+            }
+        }
+        out << "\"";
+    }
+    out << (n == 0 ? " \"\"" : "") << ";\n\n";
+    
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_CSR_OFFSETS", graph.offsets, n + 1);
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_CSR_TARGETS", graph.targets, graph.numEdges());
+    writeEmbeddedArray(out, "Weight", "BUILTIN_CSR_WEIGHTS", graph.weights, graph.numEdges());
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_COMPONENT_ROOTS", roots.data(), n);
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_COMPONENT_SIZES", sizes.data(), n);
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_SCREEN_XS", screenXs.data(), n);
+    writeEmbeddedArray(out, "int32_t", "BUILTIN_SCREEN_YS", screenYs.data(), n);
+    
+    out.precision(17);
+    out << "inline const EmbeddedGraph& builtinGraph() {\n"
+        << "    static const EmbeddedGraph graph = {\n"
+        << "        " << n << ", " << graph.numEdges() << ",\n"
+        << "        BUILTIN_XS, BUILTIN_YS, BUILTIN_NAME_OFFSETS, BUILTIN_NAMES,\n"
+        << "        BUILTIN_CSR_OFFSETS, BUILTIN_CSR_TARGETS, BUILTIN_CSR_WEIGHTS,\n"
+        << "        BUILTIN_COMPONENT_ROOTS, BUILTIN_COMPONENT_SIZES,\n"
+        << "        " << reverseArcs << ", " << duplicateArcs << ",\n"
+        << "        {" << screen.scaleX << ", " << screen.scaleY << ", " << screen.offsetX << ", " << screen.offsetY
+        << ", " << screen.windowHeight << ", BUILTIN_SCREEN_XS, BUILTIN_SCREEN_YS},\n"
+        << "    };\n"
+        << "    return graph;\n"
+        << "}\n";
+}
@@ -0,0 +1,305 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX // Jangan biarkan windows.h mendefinisikan makro min/max
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "graph_types.h"
+
+// Format file graph biner (little-endian, sesuai memori mesin):
+//   GraphFileHeader | section 0 | section 1 | ...
+// Setiap section adalah array mentah yang langsung dipakai sebagai view setelah file di-mmap,
+// jadi startup tidak perlu parsing maupun menyalin data. Offset section selaras 8 byte.
+// checksum = FNV-1a 64-bit atas semua byte setelah header.
+
+const char GRAPH_FILE_MAGIC[8] = {'M', 'A', 'P', 'S', 'G', 'R', 'F', '\0'};
+const uint32_t GRAPH_FILE_VERSION = 3; // 3: indeks setengah shortcut CH; 2: bobot uint32 fixed-point; 1: double
+const uint32_t GRAPH_FILE_HAS_HIERARCHY = 1; // flags: berisi hasil Contraction Hierarchies
+
+enum GraphFileSectionId {
+    SECTION_X,               // int32[n]
+    SECTION_Y,               // int32[n]
+    SECTION_NAME_OFFSETS,    // uint32[n + 1]
+    SECTION_NAME_CHARS,      // char[nameOffsets[n]]
+    SECTION_CSR_OFFSETS,     // int32[n + 1]
+    SECTION_CSR_TARGETS,     // int32[m]
+    SECTION_CSR_WEIGHTS,     // uint32[m], fixed-point (lihat WEIGHT_SCALE)
+    SECTION_CH_UP_OFFSETS,   // Section CH kosong jika flag GRAPH_FILE_HAS_HIERARCHY tidak ada
+    SECTION_CH_UP_TARGETS,
+    SECTION_CH_UP_WEIGHTS,
+    SECTION_CH_UP_MIDDLE,
+    SECTION_CH_UP_FIRST_HALF,
+    SECTION_CH_UP_SECOND_HALF,
+    SECTION_CH_DOWN_OFFSETS,
+    SECTION_CH_DOWN_TARGETS,
+    SECTION_CH_DOWN_WEIGHTS,
+    SECTION_CH_DOWN_MIDDLE,
+    SECTION_CH_DOWN_FIRST_HALF,
+    SECTION_CH_DOWN_SECOND_HALF,
+    GRAPH_FILE_SECTION_COUNT
+};
+
+struct GraphFileSection {
+    uint64_t offset; // Dari awal file
+    uint64_t bytes;
+};
+
+struct GraphFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t checksum;
+    uint64_t fileBytes;
+    uint32_t nodeCount;
+    uint32_t edgeCount;
+    uint32_t shortcutCount;
+    uint32_t sectionCount;
+    GraphFileSection sections[GRAPH_FILE_SECTION_COUNT];
+};
+
+inline uint64_t fnv1a64(const unsigned char* data, size_t bytes, uint64_t hash = 1469598103934665603ULL) {
+    for (size_t i = 0; i < bytes; i++) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Penulis file graph: tambahkan section sesuai urutan GraphFileSectionId lalu finish()
+class GraphFileWriter {
+private:
+    FILE* file = nullptr;
+    GraphFileHeader header;
+    uint64_t position = sizeof(GraphFileHeader);
+    uint64_t checksum = 1469598103934665603ULL;
+    int nextSection = 0;
+    
+    void writeBytes(const void* data, size_t bytes) {
+        fwrite(data, 1, bytes, file);
+        checksum = fnv1a64((const unsigned char*)data, bytes, checksum);
+        position += bytes;
+    }
+    
+public:
+    bool open(const string& path, uint32_t nodeCount, uint32_t edgeCount, uint32_t flags, uint32_t shortcutCount) {
+        file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, GRAPH_FILE_MAGIC, sizeof(header.magic));
+        header.version = GRAPH_FILE_VERSION;
+        header.flags = flags;
+        header.nodeCount = nodeCount;
+        header.edgeCount = edgeCount;
+        header.shortcutCount = shortcutCount;
+        header.sectionCount = GRAPH_FILE_SECTION_COUNT;
+        // Header ditulis ulang di finish() setelah offset dan checksum diketahui
+        fwrite(&header, 1, sizeof(header), file);
+        return true;
+    }
+    
+    void addSection(const void* data, size_t bytes) {
+        static const unsigned char padding[8] = {0};
+        if (position % 8 != 0) {
+            writeBytes(padding, 8 - position % 8);
+        }
+        header.sections[nextSection].offset = position;
+        header.sections[nextSection].bytes = bytes;
+        nextSection++;
+        if (bytes > 0) writeBytes(data, bytes);
+    }
+    
+    bool finish() {
+        header.checksum = checksum;
+        header.fileBytes = position;
+        fseek(file, 0, SEEK_SET);
+        fwrite(&header, 1, sizeof(header), file);
+        bool ok = !ferror(file) && nextSection == GRAPH_FILE_SECTION_COUNT;
+        fclose(file);
+        file = nullptr;
+        return ok;
+    }
+};
+
+// File graph yang di-mmap read-only. Semua pointer section menunjuk langsung ke halaman file,
+// jadi objek ini harus tetap hidup selama graph yang memakainya masih dipakai.
+class MappedGraphFile {
+private:
+    const unsigned char* base = nullptr;
+    size_t size = 0;
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mappingHandle = NULL;
+#endif
+    string errorMessage;
+    
+    bool fail(const string& message) {
+        errorMessage = message;
+        close();
+        return false;
+    }
+    
+    // CSR offsets[0..n] naik dari 0 sampai m dan semua target < n
+    static bool validCsr(const int32_t* offsets, const int32_t* targets, uint64_t n, uint64_t m) {
+        if (offsets[0] != 0 || (uint64_t)offsets[n] != m) return false;
+        for (uint64_t u = 0; u < n; u++) {
+            if (offsets[u] > offsets[u + 1]) return false;
+        }
+        for (uint64_t e = 0; e < m; e++) {
+            if (targets[e] < 0 || (uint64_t)targets[e] >= n) return false;
+        }
+        return true;
+    }
+    
+    // Satu graph naik CH (lihat ContractionHierarchy::UpwardArrays) dengan section mulai dari first.
+    // Setengah shortcut harus menunjuk edge di simpul middle pada graph naik yang benar; ini cukup
+    // agar penguraian shortcut tidak membaca di luar array.
+    bool validUpward(GraphFileSectionId first, uint64_t n, const int32_t* halfOffsets[2], uint64_t halfCounts[2]) const {
+        const GraphFileSection* s = header().sections + first;
+        uint64_t m = s[1].bytes / 4;
+        if (s[0].bytes != (n + 1) * 4 || s[2].bytes != m * sizeof(Weight) || s[3].bytes != m * 4 || s[4].bytes != m * 4 ||
+            s[5].bytes != m * 4) {
+            return false;
+        }
+        const int32_t* offsets = section<int32_t>(first);
+        if (!validCsr(offsets, section<int32_t>((GraphFileSectionId)(first + 1)), n, m)) return false;
+        const int32_t* middle = section<int32_t>((GraphFileSectionId)(first + 3));
+        const int32_t* halves[2] = {section<int32_t>((GraphFileSectionId)(first + 4)),
+                                    section<int32_t>((GraphFileSectionId)(first + 5))};
+        for (uint64_t e = 0; e < m; e++) {
+            if (middle[e] == -1) continue;
+            if (middle[e] < 0 || (uint64_t)middle[e] >= n) return false;
+            for (int k = 0; k < 2; k++) {
+                int64_t half = halves[k][e];
+                if (half < halfOffsets[k][middle[e]] || half >= halfOffsets[k][middle[e] + 1] ||
+                    (uint64_t)half >= halfCounts[k]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+    
+    void close() {
+#ifdef _WIN32
+        if (base) UnmapViewOfFile(base);
+        if (mappingHandle) CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mappingHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (base) munmap((void*)base, size);
+#endif
+        base = nullptr;
+        size = 0;
+    }
+    
+public:
+    MappedGraphFile() = default;
+    MappedGraphFile(const MappedGraphFile&) = delete;
+    MappedGraphFile& operator=(const MappedGraphFile&) = delete;
+    ~MappedGraphFile() { close(); }
+    
+    // Map file dan periksa header; verifyChecksum membaca seluruh file (lebih lambat)
+    bool open(const string& path, bool verifyChecksum) {
+        close();
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE) return fail("File tidak bisa dibuka: " + path);
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(fileHandle, &fileSize);
+        size = (size_t)fileSize.QuadPart;
+        if (size < sizeof(GraphFileHeader)) return fail("File graph terlalu kecil");
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (!mappingHandle) return fail("File graph tidak bisa di-map");
+        base = (const unsigned char*)MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+        if (!base) return fail("File graph tidak bisa di-map");
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return fail("File tidak bisa dibuka: " + path);
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(GraphFileHeader)) {
+            ::close(fd);
+            return fail("File graph terlalu kecil");
+        }
+        size = info.st_size;
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            size = 0;
+            return fail("File graph tidak bisa di-map");
+        }
+        base = (const unsigned char*)mapped;
+#endif
+
+        const GraphFileHeader& h = header();
+        if (memcmp(h.magic, GRAPH_FILE_MAGIC, sizeof(h.magic)) != 0) return fail("Bukan file graph");
+        if (h.version != GRAPH_FILE_VERSION) return fail("Versi file graph tidak didukung");
+        if (h.fileBytes != size || h.sectionCount != GRAPH_FILE_SECTION_COUNT) return fail("File graph rusak atau terpotong");
+        for (int s = 0; s < GRAPH_FILE_SECTION_COUNT; s++) {
+            if (h.sections[s].offset % 8 != 0 || h.sections[s].offset + h.sections[s].bytes > size) {
+                return fail("File graph rusak atau terpotong");
+            }
+        }
+        uint64_t n = h.nodeCount, m = h.edgeCount;
+        if (h.sections[SECTION_X].bytes != n * 4 || h.sections[SECTION_Y].bytes != n * 4 ||
+            h.sections[SECTION_NAME_OFFSETS].bytes != (n + 1) * 4 || h.sections[SECTION_CSR_OFFSETS].bytes != (n + 1) * 4 ||
+            h.sections[SECTION_CSR_TARGETS].bytes != m * 4 || h.sections[SECTION_CSR_WEIGHTS].bytes != m * sizeof(Weight)) {
+            return fail("Ukuran section file graph tidak sesuai header");
+        }
+        
+        // Pemeriksaan struktur O(n + m) selalu dijalankan: data yang rusak tidak boleh membuat
+        // pencarian membaca di luar array. Checksum (--verify) membandingkan seluruh isi file.
+        const uint32_t* nameOffsets = section<uint32_t>(SECTION_NAME_OFFSETS);
+        for (uint64_t i = 0; i < n; i++) {
+            if (nameOffsets[i] > nameOffsets[i + 1]) return fail("Struktur file graph tidak valid: nama lokasi");
+        }
+        if (nameOffsets[0] != 0 || nameOffsets[n] != h.sections[SECTION_NAME_CHARS].bytes) {
+            return fail("Struktur file graph tidak valid: nama lokasi");
+        }
+        if (!validCsr(section<int32_t>(SECTION_CSR_OFFSETS), section<int32_t>(SECTION_CSR_TARGETS), n, m)) {
+            return fail("Struktur file graph tidak valid: edge");
+        }
+        if (hasHierarchy()) {
+            // firstHalf menunjuk edge di graph turun (backward), secondHalf di graph naik (forward)
+            const int32_t* halfOffsets[2] = {section<int32_t>(SECTION_CH_DOWN_OFFSETS), section<int32_t>(SECTION_CH_UP_OFFSETS)};
+            uint64_t halfCounts[2] = {h.sections[SECTION_CH_DOWN_TARGETS].bytes / 4, h.sections[SECTION_CH_UP_TARGETS].bytes / 4};
+            bool offsetsSized = h.sections[SECTION_CH_UP_OFFSETS].bytes == (n + 1) * 4 &&
+                                h.sections[SECTION_CH_DOWN_OFFSETS].bytes == (n + 1) * 4;
+            if (!offsetsSized || !validUpward(SECTION_CH_UP_OFFSETS, n, halfOffsets, halfCounts) ||
+                !validUpward(SECTION_CH_DOWN_OFFSETS, n, halfOffsets, halfCounts)) {
+                return fail("Struktur file graph tidak valid: Contraction Hierarchies");
+            }
+        } else {
+            for (int s = SECTION_CH_UP_OFFSETS; s < GRAPH_FILE_SECTION_COUNT; s++) {
+                if (h.sections[s].bytes != 0) return fail("Struktur file graph tidak valid: Contraction Hierarchies");
+            }
+        }
+        if (verifyChecksum && fnv1a64(base + sizeof(GraphFileHeader), size - sizeof(GraphFileHeader)) != h.checksum) {
+            return fail("Checksum file graph tidak cocok");
+        }
+        return true;
+    }
+    
+    const string& error() const { return errorMessage; }
+    const GraphFileHeader& header() const { return *(const GraphFileHeader*)base; }
+    bool hasHierarchy() const { return header().flags & GRAPH_FILE_HAS_HIERARCHY; }
+    
+    template <typename T>
+    const T* section(GraphFileSectionId id) const {
+        return (const T*)(base + header().sections[id].offset);
+    }
+};
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+const double UNIT_TO_KM = 1.0 / 1000.0;
+
+// Bobot edge disimpan sebagai fixed-point uint32: 1 = 1/WEIGHT_SCALE unit peta (1 unit = 1 m,
+// jadi resolusi sekitar 4 mm dan bobot edge maksimal sekitar 16.700 km). Panjang jalur
+// dijumlahkan sebagai uint64, sehingga seluruh pencarian memakai aritmetika integer dan jarak
+// baru diubah ke unit peta saat ditampilkan.
+typedef uint32_t Weight;
+typedef uint64_t PathLength;
+const double WEIGHT_SCALE = 256;
+const PathLength UNREACHED = numeric_limits<PathLength>::max() / 2; // Masih aman ditambah bobot
+
+// Panjang edge terpanjang yang masih muat di Weight. Edge yang lebih panjang tidak dibuat
+// (lihat RoadNetwork::selectNeighbors dan reweightEdge), bukan disimpan dengan bobot terpotong.
+const double MAX_EDGE_UNITS = numeric_limits<Weight>::max() / WEIGHT_SCALE;
+
+// Unit peta -> bobot, dibulatkan ke terdekat. units harus <= MAX_EDGE_UNITS; batas atas di
+// bawah hanya menjaga konversi double -> uint32 tetap terdefinisi.
+inline Weight toWeight(double units) {
+    double scaled = units * WEIGHT_SCALE + 0.5;
+    return scaled >= numeric_limits<Weight>::max() ? numeric_limits<Weight>::max() : (Weight)scaled;
+}
+
+inline double toUnits(PathLength length) { return length / WEIGHT_SCALE; }
+
+// Heuristik A* (jarak garis lurus) dalam satuan bobot. Dibulatkan ke bawah dan dikecilkan 1/128:
+// pembulatan bobot dan heuristik berselisih paling banyak 1,5 per edge, sedangkan edge antar
+// titik berbeda minimal WEIGHT_SCALE, jadi h(u) <= w(u, v) + h(v) tetap berlaku (konsisten)
+// dan key yang diambil dari heap tidak pernah turun.
+const double HEURISTIC_SCALE = WEIGHT_SCALE * (1 - 1.0 / 128);
+
+inline PathLength toHeuristic(double units) { return (PathLength)(units * HEURISTIC_SCALE); }
+
+struct Point {
+    int x, y;
+    string name;
+    Point(int x = 0, int y = 0, string name = "") : x(x), y(y), name(name) {}
+};
+
+struct Edge {
+    int to;
+    Weight weight;
+    Edge(int to, Weight weight) : to(to), weight(weight) {}
+};
+
+// Graph format CSR: edge milik simpul u ada di indeks [begin(u), end(u)) pada array targets dan
+// weights yang dipadatkan, jadi relaksasi edge membaca memori berurutan. Dalam bentuk padat
+// end(u) = offsets[u + 1]. Array bisa milik sendiri (hasil build) atau menunjuk ke memori lain,
+// misalnya file graph yang di-mmap (attach); keduanya diakses lewat pointer yang sama.
+//
+// Untuk pembaruan inkremental graph bisa dijadikan editable: setiap simpul mendapat slot
+// sendiri di array edge (ends[u] terpisah dari offsets[u + 1]), sehingga setRow hanya menyalin
+// baris simpul itu. Baris yang tidak muat dipindah ke ujung array; slot lama yang terbuang
+// dipadatkan ulang setelah jumlahnya melebihi separuh array.
+class CsrGraph {
+private:
+    vector<int32_t> offsetStorage;
+    vector<int32_t> endStorage;  // Hanya mode editable: akhir edge tiap simpul
+    vector<int32_t> slotEnd;     // Hanya mode editable: akhir slot (kapasitas) tiap simpul
+    vector<int32_t> targetStorage;
+    vector<Weight> weightStorage;
+    int nodeCount = 0;
+    int edgeCount = 0;
+    bool editable = false;
+    size_t wastedSlots = 0;
+    
+    void bindStorage() {
+        offsets = offsetStorage.data();
+        ends = editable ? endStorage.data() : offsets + 1;
+        targets = targetStorage.data();
+        weights = weightStorage.data();
+    }
+    
+    // Salin semua baris berurutan tanpa celah; editable = false menghasilkan bentuk padat biasa
+    void repack(bool keepEditable) {
+        vector<int32_t> newOffsets(nodeCount + 1, 0);
+        vector<int32_t> newTargets;
+        vector<Weight> newWeights;
+        newTargets.reserve(edgeCount);
+        newWeights.reserve(edgeCount);
+        for (int u = 0; u < nodeCount; u++) {
+            newOffsets[u] = newTargets.size();
+            newTargets.insert(newTargets.end(), targets + begin(u), targets + end(u));
+            newWeights.insert(newWeights.end(), weights + begin(u), weights + end(u));
+        }
+        newOffsets[nodeCount] = newTargets.size();
+        offsetStorage.swap(newOffsets);
+        targetStorage.swap(newTargets);
+        weightStorage.swap(newWeights);
+        editable = keepEditable;
+        wastedSlots = 0;
+        if (editable) {
+            endStorage.assign(offsetStorage.begin() + 1, offsetStorage.end());
+            slotEnd = endStorage;
+            offsetStorage.pop_back();
+        } else {
+            endStorage.clear();
+            slotEnd.clear();
+        }
+        bindStorage();
+    }
+    
+public:
+    const int32_t* offsets = nullptr;
+    const int32_t* ends = nullptr;
+    const int32_t* targets = nullptr;
+    const Weight* weights = nullptr;
+    
+    CsrGraph() = default;
+    CsrGraph(const CsrGraph&) = delete;            // Pointer akan menunjuk ke storage milik objek lain
+    CsrGraph& operator=(const CsrGraph&) = delete;
+    CsrGraph(CsrGraph&&) = default;                // Buffer vector ikut pindah, pointer tetap valid
+    CsrGraph& operator=(CsrGraph&&) = default;
+    
+    void build(const vector<vector<Edge>>& adjacencyList) {
+        int n = adjacencyList.size();
+        offsetStorage.assign(n + 1, 0);
+        for (int u = 0; u < n; u++) {
+            offsetStorage[u + 1] = offsetStorage[u] + adjacencyList[u].size();
+        }
+        targetStorage.resize(offsetStorage[n]);
+        weightStorage.resize(offsetStorage[n]);
+        for (int u = 0; u < n; u++) {
+            int e = offsetStorage[u];
+            for (const Edge& edge : adjacencyList[u]) {
+                targetStorage[e] = edge.to;
+                weightStorage[e] = edge.weight;
+                e++;
+            }
+        }
+        nodeCount = n;
+        edgeCount = offsetStorage[n];
+        editable = false;
+        endStorage.clear();
+        slotEnd.clear();
+        bindStorage();
+    }
+    
+    // Ambil alih array CSR yang sudah disusun pemanggil (offsets berisi n + 1 entri) tanpa menyalin
+    void adopt(vector<int32_t>&& offsetData, vector<int32_t>&& targetData, vector<Weight>&& weightData) {
+        offsetStorage = move(offsetData);
+        targetStorage = move(targetData);
+        weightStorage = move(weightData);
+        nodeCount = (int)offsetStorage.size() - 1;
+        edgeCount = offsetStorage[nodeCount];
+        editable = false;
+        endStorage.clear();
+        slotEnd.clear();
+        bindStorage();
+    }
+    
+    // Pakai array dari luar tanpa menyalin; pemanggil menjamin memorinya tetap hidup
+    void attach(int n, const int32_t* offsetData, const int32_t* targetData, const Weight* weightData) {
+        offsetStorage.clear();
+        targetStorage.clear();
+        weightStorage.clear();
+        endStorage.clear();
+        slotEnd.clear();
+        editable = false;
+        nodeCount = n;
+        edgeCount = offsetData[n];
+        offsets = offsetData;
+        ends = offsets + 1;
+        targets = targetData;
+        weights = weightData;
+    }
+    
+    int numNodes() const { return nodeCount; }
+    int numEdges() const { return edgeCount; }
+    int begin(int u) const { return offsets[u]; }
+    int end(int u) const { return ends[u]; }
+    int degree(int u) const { return ends[u] - offsets[u]; }
+    bool isEditable() const { return editable; }
+    
+    // Ubah ke mode editable (sekali O(n + m); array hasil attach ikut disalin)
+    void makeEditable() {
+        if (!editable) repack(true);
+    }
+    
+    // Kembali ke bentuk padat, misalnya sebelum disimpan ke file graph
+    void compact() {
+        if (editable) repack(false);
+    }
+    
+    // Simpul baru tanpa edge di indeks numNodes() (mode editable)
+    int addNode() {
+        int at = targetStorage.size();
+        offsetStorage.push_back(at);
+        endStorage.push_back(at);
+        slotEnd.push_back(at);
+        bindStorage();
+        return nodeCount++;
+    }
+    
+    // Ganti seluruh edge keluar simpul u (mode editable)
+    void setRow(int u, const vector<Edge>& row) {
+        int size = row.size();
+        edgeCount += size - degree(u);
+        int start = offsetStorage[u];
+        if (start + size > slotEnd[u]) {
+            // Tidak muat: pindahkan ke slot baru di ujung dengan ruang untuk tumbuh
+            wastedSlots += slotEnd[u] - start;
+            start = targetStorage.size();
+            int capacity = max(4, size * 2);
+            targetStorage.resize(start + capacity);
+            weightStorage.resize(start + capacity);
+            offsetStorage[u] = start;
+            slotEnd[u] = start + capacity;
+        }
+        for (int k = 0; k < size; k++) {
+            targetStorage[start + k] = row[k].to;
+            weightStorage[start + k] = row[k].weight;
+        }
+        endStorage[u] = start + size;
+        bindStorage();
+        if (wastedSlots > 1024 && wastedSlots * 2 > targetStorage.size()) repack(true);
+    }
+};
+
+// Satu lokasi yang dibaca dari LocationTable
+struct LocationView {
+    int x, y;
+    string_view name;
+};
+
+// Tabel lokasi dalam array datar: koordinat x dan y terpisah, semua nama disambung dalam satu
+// arena karakter dengan offset per lokasi (nama i = names[nameOffsets[i] .. nameOffsets[i + 1])).
+// Seperti CsrGraph, array bisa milik sendiri atau view ke file graph yang di-mmap.
+class LocationTable {
+private:
+    vector<int32_t> xStorage, yStorage;
+    vector<uint32_t> nameOffsetStorage = {0};
+    vector<char> nameStorage;
+    int count = 0;
+    
+    void bindStorage() {
+        xs = xStorage.data();
+        ys = yStorage.data();
+        nameOffsets = nameOffsetStorage.data();
+        names = nameStorage.data();
+    }
+    
+public:
+    const int32_t* xs = nullptr;
+    const int32_t* ys = nullptr;
+    const uint32_t* nameOffsets = nameOffsetStorage.data();
+    const char* names = nullptr;
+    
+    LocationTable() = default;
+    LocationTable(const LocationTable&) = delete;
+    LocationTable& operator=(const LocationTable&) = delete;
+    LocationTable(LocationTable&&) = default;
+    LocationTable& operator=(LocationTable&&) = default;
+    
+    void reserve(size_t locationCount, size_t nameBytes) {
+        xStorage.reserve(locationCount);
+        yStorage.reserve(locationCount);
+        nameOffsetStorage.reserve(locationCount + 1);
+        nameStorage.reserve(nameBytes);
+        bindStorage();
+    }
+    
+    void add(int x, int y, string_view name) {
+        xStorage.push_back(x);
+        yStorage.push_back(y);
+        nameStorage.insert(nameStorage.end(), name.begin(), name.end());
+        nameOffsetStorage.push_back(nameStorage.size());
+        count++;
+        bindStorage();
+    }
+    
+    // Salin array view (misalnya dari file graph) ke storage sendiri agar bisa ditambah
+    void makeOwned() {
+        if (count == 0 || xs == xStorage.data()) return;
+        xStorage.assign(xs, xs + count);
+        yStorage.assign(ys, ys + count);
+        nameOffsetStorage.assign(nameOffsets, nameOffsets + count + 1);
+        nameStorage.assign(names, names + nameOffsets[count]);
+        bindStorage();
+    }
+    
+    void attach(int n, const int32_t* xData, const int32_t* yData, const uint32_t* nameOffsetData, const char* nameData) {
+        xStorage.clear();
+        yStorage.clear();
+        nameOffsetStorage.clear();
+        nameStorage.clear();
+        count = n;
+        xs = xData;
+        ys = yData;
+        nameOffsets = nameOffsetData;
+        names = nameData;
+    }
+    
+    int size() const { return count; }
+    size_t nameBytes() const { return nameOffsets[count]; }
+    string_view name(int i) const { return string_view(names + nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]); }
+    LocationView operator[](int i) const { return {xs[i], ys[i], name(i)}; }
+};
+
+// Instrumentasi hot path pencarian. Bangun dengan -DMAPS_INSTRUMENTATION=0 untuk menghapus
+// semua penghitung dan pengukuran waktu per query dari kode pencarian.
+#ifndef MAPS_INSTRUMENTATION
+#define MAPS_INSTRUMENTATION 1
+#endif
+
+#if MAPS_INSTRUMENTATION
+#define SEARCH_STAT(...) __VA_ARGS__
+#else
+#define SEARCH_STAT(...)
+#endif
+
+// Penghitung kerja satu pencarian (nol semua jika instrumentasi dimatikan)
+struct SearchCounters {
+    long long heapPushes = 0;
+    long long heapPops = 0;
+    long long relaxations = 0; // Edge yang diperiksa dari simpul yang diproses
+    long long settled = 0;
+    
+    // Entri heap usang yang dilewati karena simpulnya sudah diproses
+    long long stalePops() const { return heapPops - settled; }
+    
+    SearchCounters& operator+=(const SearchCounters& o) {
+        heapPushes += o.heapPushes;
+        heapPops += o.heapPops;
+        relaxations += o.relaxations;
+        settled += o.settled;
+        return *this;
+    }
+};
+
+// Hasil satu query titik ke titik: hanya jarak ke tujuan dan jalurnya (kosong jika tidak terhubung)
+struct RouteResult {
+    double distance = numeric_limits<double>::infinity(); // Unit peta (lihat toUnits)
+    vector<int> path;
+    int settledNodes = 0; // Jumlah simpul yang diproses (ukuran ruang pencarian)
+    SearchCounters counters;
+    double micros = 0;    // Waktu query (diisi findRoute jika instrumentasi aktif)
+};
+
+// Algoritma pencarian titik ke titik yang bisa dipilih dari menu
+enum SearchMode {
+    MODE_DIJKSTRA,
+    MODE_ASTAR,
+    MODE_BIDIRECTIONAL,
+    MODE_BIDIRECTIONAL_ASTAR,
+    MODE_CONTRACTION_HIERARCHIES,
+    SEARCH_MODE_COUNT
+};
+
+inline const char* searchModeName(SearchMode mode) {
+    switch (mode) {
+        case MODE_DIJKSTRA: return "Dijkstra";
+        case MODE_ASTAR: return "A*";
+        case MODE_BIDIRECTIONAL: return "Dijkstra dua arah";
+        case MODE_BIDIRECTIONAL_ASTAR: return "A* dua arah";
+        case MODE_CONTRACTION_HIERARCHIES: return "Contraction Hierarchies";
+        default: return "?";
+    }
+}
+
+// Nama mode untuk argumen --mode dan output yang dibaca mesin
+inline const char* searchModeKey(SearchMode mode) {
+    const char* keys[] = {"dijkstra", "astar", "bidirectional", "bidirectional-astar", "ch"};
+    return mode >= 0 && mode < SEARCH_MODE_COUNT ? keys[mode] : "?";
+}
+
+inline bool parseSearchMode(const string& name, SearchMode& mode) {
+    for (int m = 0; m < SEARCH_MODE_COUNT; m++) {
+        if (name == searchModeKey((SearchMode)m)) {
+            mode = (SearchMode)m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Ringkasan hasil ensureBidirectionalConnections
+struct SymmetrizeStats {
+    int added = 0;      // Jumlah edge balik yang ditambahkan
+    int duplicates = 0; // Jumlah edge ganda yang dibuang
+    int tooLong = 0;    // Koneksi cadangan yang tidak dibuat karena melebihi MAX_EDGE_UNITS
+};
+
+// Waktu tiap tahap buildGraph (detik), untuk benchmark
+struct BuildTimings {
+    double neighbors = 0;  // Pencarian tetangga terdekat lewat grid
+    double symmetrize = 0; // ensureBidirectionalConnections
+    double compact = 0;    // Pemadatan ke CSR
+    int threads = 1;       // Jumlah thread yang dipakai
+};
@@ -0,0 +1,229 @@
+// Generator beban untuk server query (maps --serve, khusus Linux). Setiap koneksi menjaga
+// sampai P permintaan rute acak dalam perjalanan, lalu hasilnya dilaporkan sebagai satu objek
+// JSON di stdout: throughput, latensi p50/p99/p99.9 (diukur di klien) dan penghitung server.
+//
+//   maps_load --socket <path> [--connections 8] [--requests 20000] [--pipeline 16]
+//             [--hot K] [--seed 42]
+//
+// --hot K mengambil lokasi awal dari K lokasi saja (default: semua), sehingga permintaan dengan
+// lokasi awal sama sering datang bersamaan dan bisa digabung oleh server.
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace std;
+
+struct LoadConfig {
+    string socketPath;
+    int connections = 8;
+    int requests = 20000;
+    int pipeline = 16;
+    int hot = 0;
+    unsigned long long seed = 42;
+};
+
+// Koneksi blocking ke server dengan pembaca baris sederhana
+class LineClient {
+private:
+    int fd = -1;
+    string buffer;
+    
+public:
+    ~LineClient() {
+        if (fd >= 0) close(fd);
+    }
+    
+    bool connectTo(const string& path) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) return false;
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        return fd >= 0 && connect(fd, (sockaddr*)&address, sizeof(address)) == 0;
+    }
+    
+    bool sendAll(const string& data) {
+        size_t done = 0;
+        while (done < data.size()) {
+            ssize_t sent = send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+            if (sent < 0 && errno == EINTR) continue;
+            if (sent <= 0) return false;
+            done += sent;
+        }
+        return true;
+    }
+    
+    bool readLine(string& line) {
+        while (true) {
+            size_t newline = buffer.find('\n');
+            if (newline != string::npos) {
+                line = buffer.substr(0, newline);
+                buffer.erase(0, newline + 1);
+                return true;
+            }
+            char chunk[65536];
+            ssize_t got = recv(fd, chunk, sizeof(chunk), 0);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            buffer.append(chunk, got);
+        }
+    }
+};
+
+// Minta satu baris dari server (info/stats) lewat koneksi baru
+bool askServer(const string& path, const string& command, string& reply) {
+    LineClient client;
+    return client.connectTo(path) && client.sendAll(command + "\n") && client.readLine(reply);
+}
+
+long long jsonNumber(const string& json, const string& key) {
+    size_t pos = json.find("\"" + key + "\":");
+    return pos == string::npos ? -1 : atoll(json.c_str() + pos + key.size() + 3);
+}
+
+struct ConnectionResult {
+    vector<double> latencies; // Mikrodetik per permintaan
+    int errors = 0;
+    bool failed = false;
+};
+
+void runConnection(const LoadConfig& config, int index, int quota, int locations, ConnectionResult& result) {
+    LineClient client;
+    if (!client.connectTo(config.socketPath)) {
+        result.failed = true;
+        return;
+    }
+    mt19937_64 rng(config.seed + index);
+    uniform_int_distribution<int> anyLocation(1, locations);
+    // Lokasi "populer" sama untuk semua koneksi: diturunkan dari seed, bukan dari index
+    vector<int> hotSources;
+    mt19937_64 hotRng(config.seed);
+    for (int k = 0; k < config.hot; k++) hotSources.push_back(anyLocation(hotRng));
+    uniform_int_distribution<int> hotPick(0, max(0, config.hot - 1));
+    
+    result.latencies.reserve(quota);
+    deque<chrono::steady_clock::time_point> sentAt;
+    int sent = 0, received = 0;
+    string batch, line;
+    while (received < quota) {
+        batch.clear();
+        while (sent < quota && sent - received < config.pipeline) {
+            int start = hotSources.empty() ? anyLocation(rng) : hotSources[hotPick(rng)];
+            batch += to_string(start) + " " + to_string(anyLocation(rng)) + "\n";
+            sentAt.push_back(chrono::steady_clock::now());
+            sent++;
+        }
+        if (!batch.empty() && !client.sendAll(batch)) {
+            result.failed = true;
+            return;
+        }
+        if (!client.readLine(line)) {
+            result.failed = true;
+            return;
+        }
+        result.latencies.push_back(
+            chrono::duration<double, micro>(chrono::steady_clock::now() - sentAt.front()).count());
+        sentAt.pop_front();
+        if (line.find("\"error\"") != string::npos) result.errors++;
+        received++;
+    }
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t index = min(sorted.size() - 1, (size_t)(p * (sorted.size() - 1) + 0.5));
+    return sorted[index];
+}
+
+int main(int argc, char** argv) {
+    LoadConfig config;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            config.socketPath = argv[++i];
+        } else if (arg == "--connections" && i + 1 < argc) {
+            config.connections = max(1, atoi(argv[++i]));
+        } else if (arg == "--requests" && i + 1 < argc) {
+            config.requests = max(1, atoi(argv[++i]));
+        } else if (arg == "--pipeline" && i + 1 < argc) {
+            config.pipeline = max(1, atoi(argv[++i]));
+        } else if (arg == "--hot" && i + 1 < argc) {
+            config.hot = max(0, atoi(argv[++i]));
+        } else if (arg == "--seed" && i + 1 < argc) {
+            config.seed = strtoull(argv[++i], nullptr, 10);
+        } else {
+            cerr << "Argumen tidak dikenal: " << arg << endl;
+            return 1;
+        }
+    }
+    if (config.socketPath.empty()) {
+        cerr << "Pemakaian: maps_load --socket <path> [--connections C] [--requests N] [--pipeline P] [--hot K]" << endl;
+        return 1;
+    }
+    
+    string info;
+    if (!askServer(config.socketPath, "info", info)) {
+        cerr << "Tidak bisa terhubung ke server di " << config.socketPath << endl;
+        return 1;
+    }
+    int locations = (int)jsonNumber(info, "locations");
+    if (locations < 1) {
+        cerr << "Balasan info tidak dikenal: " << info << endl;
+        return 1;
+    }
+    string before, after;
+    askServer(config.socketPath, "stats", before);
+    
+    vector<ConnectionResult> results(config.connections);
+    vector<thread> threads;
+    auto began = chrono::steady_clock::now();
+    for (int c = 0; c < config.connections; c++) {
+        // Sisa pembagian dibagi ke koneksi pertama agar total tepat config.requests
+        int quota = config.requests / config.connections + (c < config.requests % config.connections ? 1 : 0);
+        threads.emplace_back(runConnection, cref(config), c, quota, locations, ref(results[c]));
+    }
+    for (thread& t : threads) {
+        t.join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - began).count();
+    askServer(config.socketPath, "stats", after);
+    
+    vector<double> latencies;
+    int errors = 0, failedConnections = 0;
+    for (const ConnectionResult& r : results) {
+        latencies.insert(latencies.end(), r.latencies.begin(), r.latencies.end());
+        errors += r.errors;
+        if (r.failed) failedConnections++;
+    }
+    sort(latencies.begin(), latencies.end());
+    
+    // Selisih penghitung server selama pengukuran (termasuk permintaan stats itu sendiri)
+    long long searches = jsonNumber(after, "searches") - jsonNumber(before, "searches");
+    long long coalesced = jsonNumber(after, "coalesced") - jsonNumber(before, "coalesced");
+    
+    char line[512];
+    snprintf(line, sizeof(line),
+             "{\"bench\":\"server\",\"locations\":%d,\"connections\":%d,\"pipeline\":%d,\"hot\":%d,\"requests\":%d,"
+             "\"seconds\":%.3f,\"rps\":%.1f,\"p50_us\":%.1f,\"p99_us\":%.1f,\"p999_us\":%.1f,\"max_us\":%.1f,"
+             "\"errors\":%d,\"failed_connections\":%d,\"server_searches\":%lld,\"server_coalesced\":%lld}",
+             locations, config.connections, config.pipeline, config.hot, (int)latencies.size(), seconds,
+             seconds > 0 ? latencies.size() / seconds : 0.0, percentile(latencies, 0.5), percentile(latencies, 0.99),
+             percentile(latencies, 0.999), latencies.empty() ? 0.0 : latencies.back(), errors, failedConnections,
+             searches, coalesced);
+    cout << line << endl;
+    return failedConnections == 0 ? 0 : 1;
+}
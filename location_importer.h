@@ -0,0 +1,162 @@
+#pragma once
+
+#include <charconv>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "graph_types.h"
+
+struct ImportStats {
+    long long rows = 0;      // Baris yang masuk ke tabel lokasi
+    long long skipped = 0;   // Header, komentar, baris kosong atau tidak valid
+    long long bytes = 0;
+    double seconds = 0;
+};
+
+// Importer lokasi dari file CSV "x,y,nama" (satu lokasi per baris) yang dibaca secara streaming:
+// buffer berukuran tetap, angka diurai dengan from_chars dan nama langsung disalin ke arena
+// LocationTable, jadi tidak ada string per baris. Memori puncak = buffer + tabel lokasi itu sendiri.
+// Baris yang diawali '#' dan baris yang tidak valid (misalnya header) dilewati.
+class LocationImporter {
+private:
+    static const size_t BUFFER_SIZE = 1 << 20; // Baris lebih panjang dari ini dianggap tidak valid
+    
+    vector<char> buffer;
+    string errorMessage;
+    
+    static const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && (*p == ' ' || *p == '\t')) p++;
+        return p;
+    }
+    
+    // Urai "x,y,nama" pada [p, end) tanpa newline; false jika formatnya tidak cocok
+    static bool parseLine(const char* p, const char* end, int& x, int& y, string_view& name) {
+        p = skipSpaces(p, end);
+        auto rx = from_chars(p, end, x);
+        if (rx.ec != errc()) return false;
+        p = skipSpaces(rx.ptr, end);
+        if (p == end || *p != ',') return false;
+        p = skipSpaces(p + 1, end);
+        auto ry = from_chars(p, end, y);
+        if (ry.ec != errc()) return false;
+        p = skipSpaces(ry.ptr, end);
+        if (p < end && *p != ',') return false;
+        if (p < end) p = skipSpaces(p + 1, end);
+        
+        while (end > p && (end[-1] == ' ' || end[-1] == '\t')) end--;
+        if (end - p >= 2 && *p == '"' && end[-1] == '"') {
+            p++;
+            end--;
+        }
+        name = string_view(p, end - p);
+        return true;
+    }
+    
+public:
+    LocationImporter() : buffer(BUFFER_SIZE) {}
+    
+    const string& error() const { return errorMessage; }
+    
+    // Tambahkan semua baris valid dari path ke table. progress (boleh nullptr) menerima laporan
+    // berkala berisi jumlah baris dan throughput; ringkasan akhir ada di stats.
+    bool importCsv(const string& path, LocationTable& table, ImportStats& stats, ostream* progress = nullptr) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            errorMessage = "File tidak bisa dibuka: " + path;
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        long long fileBytes = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        
+        stats = ImportStats();
+        auto began = chrono::steady_clock::now();
+        auto lastReport = began;
+        bool reserved = false;
+        bool skippingLongLine = false;
+        size_t carry = 0; // Sisa baris yang belum lengkap di awal buffer
+        
+        while (true) {
+            size_t got = fread(buffer.data() + carry, 1, BUFFER_SIZE - carry, file);
+            stats.bytes += got;
+            size_t filled = carry + got;
+            bool eof = got == 0;
+            if (filled == 0) break;
+            
+            const char* p = buffer.data();
+            const char* limit = p + filled;
+            while (p < limit) {
+                const char* newline = (const char*)memchr(p, '\n', limit - p);
+                if (!newline && !eof) break; // Baris terpotong: lanjutkan setelah buffer diisi ulang
+                const char* lineEnd = newline ? newline : limit;
+                const char* next = newline ? newline + 1 : limit;
+                if (skippingLongLine) {
+                    skippingLongLine = false;
+                    p = next;
+                    continue;
+                }
+                if (lineEnd > p && lineEnd[-1] == '\r') lineEnd--;
+                
+                int x, y;
+                string_view name;
+                if (p < lineEnd && *p != '#' && parseLine(p, lineEnd, x, y, name)) {
+                    table.add(x, y, name);
+                    stats.rows++;
+                } else {
+                    stats.skipped++;
+                }
+                p = next;
+            }
+            
+            carry = limit - p;
+            if (carry == BUFFER_SIZE) {
+                // Satu baris memenuhi seluruh buffer: buang dan lewati sampai newline berikutnya
+                stats.skipped++;
+                skippingLongLine = true;
+                carry = 0;
+            } else if (carry > 0) {
+                memmove(buffer.data(), p, carry);
+            }
+            if (eof) break;
+            
+            // Perkirakan jumlah baris dari rata-rata ukuran baris agar tabel tidak tumbuh berkali-kali
+            if (!reserved && stats.rows > 0) {
+                double bytesPerRow = (double)(stats.bytes - carry) / (stats.rows + stats.skipped);
+                size_t estimate = (size_t)(fileBytes / bytesPerRow * 1.05) + 16;
+                table.reserve(table.size() + estimate, table.nameBytes() + (size_t)(fileBytes * 0.6));
+                reserved = true;
+            }
+            
+            auto now = chrono::steady_clock::now();
+            if (progress && chrono::duration<double>(now - lastReport).count() >= 1.0) {
+                lastReport = now;
+                double elapsed = chrono::duration<double>(now - began).count();
+                char line[160];
+                snprintf(line, sizeof(line), "\rImpor: %lld baris, %.1f/%.1f MB, %.1f MB/s",
+                         stats.rows, stats.bytes / 1e6, fileBytes / 1e6, stats.bytes / 1e6 / elapsed);
+                *progress << line << flush;
+            }
+        }
+        bool failed = ferror(file);
+        fclose(file);
+        
+        stats.seconds = chrono::duration<double>(chrono::steady_clock::now() - began).count();
+        if (progress) {
+            char line[200];
+            snprintf(line, sizeof(line), "\rImpor selesai: %lld baris (%lld dilewati), %.1f MB dalam %.2f s (%.0f baris/s)\n",
+                     stats.rows, stats.skipped, stats.bytes / 1e6, stats.seconds,
+                     stats.seconds > 0 ? stats.rows / stats.seconds : 0.0);
+            *progress << line << flush;
+        }
+        if (failed) {
+            errorMessage = "Gagal membaca file: " + path;
+            return false;
+        }
+        return true;
+    }
+};
@@ -1,5 +1,4 @@
 #include <iostream>
-#include <graphics.h>
 #include <vector>
 #include <queue>
 #include <limits>
@@ -7,169 +6,96 @@
 #include <iomanip>
 #include <string>
 #include <cstdlib>
-#include <conio.h>
 #include <algorithm>  // Added for sort and reverse functions
+#include <fstream>
+#include <sstream>
+#include <map>
+
+// Tampilan grafis BGI hanya tersedia jika graphics.h ada (TDM-GCC/WinBGIm di Windows).
+// Tanpa BGI, program tetap bisa dibangun di Linux untuk menu teks dan mode batch.
+#if __has_include(<graphics.h>)
+#include <graphics.h>
+#include <conio.h>
+#define HAS_BGI 1
+#else
+#define HAS_BGI 0
+#endif
+
+#include "batch_query.h"
+#include "builtin_graph.h"
+#include "location_importer.h"
+#include "map_renderer.h"
+#include "road_network.h"
+#include "tour_optimizer.h"
+
+// Server query lewat Unix domain socket memakai epoll, jadi hanya dibangun di Linux
+#ifdef __linux__
+#include "query_server.h"
+#define HAS_QUERY_SERVER 1
+#else
+#define HAS_QUERY_SERVER 0
+#endif
 
 using namespace std;
 
-struct Point {
-    int x, y;
-    string name;
-    Point(int x = 0, int y = 0, string name = "") : x(x), y(y), name(name) {}
-};
+// 20 lokasi bawaan sesuai koordinat yang diberikan
+vector<Point> defaultLocations() {
+    return {
+        Point(2070, 2995, "Pesantren Islam Al Irsyad"),
+        Point(1810, 3400, "Penginapan Ummu Yasmin"),
+        Point(575, 2525, "Raff Kos"),
+        Point(370, 2180, "GCC Makmur Indonesia Project"),
+        Point(1625, 1755, "Pesantren Islam Al Irsyad Putri"),
+        Point(3095, 1720, "Penginapan Walisantri AMMA"),
+        Point(2515, 685, "Lapangan Desa Butuh"),
+        Point(3915, 390, "Geral Samsat Tengaran"),
+        Point(3860, 730, "SPBU PERTAMINA Butuh"),
+        Point(4470, 575, "Joglo Kebon Ndhelik"),
+        Point(5780, 1285, "Lapangan Karang Duren"),
+        Point(6650, 1775, "Kezia Grosir Ikan Hias Murah"),
+        Point(4505, 1665, "Ponpes Nurul Islam Tengaran"),
+        Point(4620, 2170, "PT Japfa Comfeed Indonesia"),
+        Point(5080, 2450, "Amelia House"),
+        Point(5790, 3325, "Musholla Arrahman"),
+        Point(5400, 3565, "Iguana Kos"),
+        Point(3630, 3555, "Rocket Chicken Tengaran"),
+        Point(3825, 2385, "SPBU PERTAMINA Klero"),
+        Point(2910, 2745, "Masjid Sabilul Khairat"),
+    };
+}
 
-struct Edge {
-    int to;
-    double weight;
-    Edge(int to, double weight) : to(to), weight(weight) {}
-};
+// Ukuran jendela BGI; tata letak layar graph bawaan dihitung untuk ukuran ini
+const int MAP_WINDOW_WIDTH = 1920;
+const int MAP_WINDOW_HEIGHT = 1080;
 
+// Menu interaktif (konsol + tampilan grafis BGI) di atas RoadNetwork
 class GoogleMapsSimulator {
 private:
-    vector<Point> locations;
-    vector<vector<Edge>> graph;
-    int numLocations;
+    RoadNetwork& network;
+    MapRenderer renderer; // Tampilan grafis tanpa BGI (file PPM); tile dasar dipakai ulang antar gambar
     
-    // Skala dan offset untuk menampilkan koordinat di layar
-    double SCALE_X = 0.08;
-    double SCALE_Y = 0.08;
-    int OFFSET_X = 50;
-    int OFFSET_Y = 50;
-    int WINDOW_WIDTH = 1920;
-    int WINDOW_HEIGHT = 1080;
-    const double UNIT_TO_KM = 1.0 / 1000.0;
-    
-    // Menghitung jarak Euclidean antara dua titik
-    double calculateDistance(const Point& a, const Point& b) {
-        return sqrt(pow(a.x - b.x, 2) + pow(a.y - b.y, 2));
-    }
+    int WINDOW_WIDTH = MAP_WINDOW_WIDTH;
+    int WINDOW_HEIGHT = MAP_WINDOW_HEIGHT;
+    ScreenLayout screen; // Skala dan offset untuk menampilkan koordinat di layar
     
-    // Konversi koordinat ke layar
-    int toScreenX(int worldX) {
-        return (int)(worldX * SCALE_X) + OFFSET_X;
+    // Posisi layar lokasi; tabel graph bawaan sudah berisi hasilnya
+    int screenX(int location) const {
+        return screen.xs ? screen.xs[location] : screen.toScreenX(network.locations.xs[location]);
     }
     
-    int toScreenY(int worldY) {
-        return WINDOW_HEIGHT - ((int)(worldY * SCALE_Y) + OFFSET_Y);
+    int screenY(int location) const {
+        return screen.ys ? screen.ys[location] : screen.toScreenY(network.locations.ys[location]);
     }
     
 public:
-    GoogleMapsSimulator() {
-        // Inisialisasi 20 lokasi sesuai koordinat yang diberikan
-        locations = {
-            Point(2070, 2995, "Pesantren Islam Al Irsyad"),
-            Point(1810, 3400, "Penginapan Ummu Yasmin"),
-            Point(575, 2525, "Raff Kos"),
-            Point(370, 2180, "GCC Makmur Indonesia Project"),
-            Point(1625, 1755, "Pesantren Islam Al Irsyad Putri"),
-            Point(3095, 1720, "Penginapan Walisantri AMMA"),
-            Point(2515, 685, "Lapangan Desa Butuh"),
-            Point(3915, 390, "Geral Samsat Tengaran"),
-            Point(3860, 730, "SPBU PERTAMINA Butuh"),
-            Point(4470, 575, "Joglo Kebon Ndhelik"),
-            Point(5780, 1285, "Lapangan Karang Duren"),
-            Point(6650, 1775, "Kezia Grosir Ikan Hias Murah"),
-            Point(4505, 1665, "Ponpes Nurul Islam Tengaran"),
-            Point(4620, 2170, "PT Japfa Comfeed Indonesia"),
-            Point(5080, 2450, "Amelia House"),
-            Point(5790, 3325, "Musholla Arrahman"),
-            Point(5400, 3565, "Iguana Kos"),
-            Point(3630, 3555, "Rocket Chicken Tengaran"),
-            Point(3825, 2385, "SPBU PERTAMINA Klero"),
-            Point(2910, 2745, "Masjid Sabilul Khairat"),
-        };
-        
-        numLocations = locations.size();
-        graph.resize(numLocations);
-        
-        // Hitung bounding box lokasi
-        int minX = locations[0].x, maxX = locations[0].x;
-        int minY = locations[0].y, maxY = locations[0].y;
-        for (const auto& p : locations) {
-            if (p.x < minX) minX = p.x;
-            if (p.x > maxX) maxX = p.x;
-            if (p.y < minY) minY = p.y;
-            if (p.y > maxY) maxY = p.y;
-        }
-        int mapWidth = maxX - minX;
-        int mapHeight = maxY - minY;
-        // Window size sudah fix 1000x700
-        SCALE_X = (WINDOW_WIDTH - 200.0) / mapWidth;
-        SCALE_Y = (WINDOW_HEIGHT - 200.0) / mapHeight;
-        // Offset agar peta di tengah
-        OFFSET_X = (WINDOW_WIDTH - (int)(mapWidth * SCALE_X)) / 2 - (int)(minX * SCALE_X);
-        OFFSET_Y = (WINDOW_HEIGHT - (int)(mapHeight * SCALE_Y)) / 2 - (int)(minY * SCALE_Y);
-        
-        // Membuat graph dengan menghubungkan setiap lokasi ke lokasi terdekat
-        buildGraph();
-    }
-    
-    void buildGraph() {
-        // Membuat graph realistis - hanya menghubungkan dengan titik terdekat
-        // Tidak menggunakan complete graph, tapi berdasarkan jarak terdekat
-        
-        const int MAX_CONNECTIONS = 5; // Maksimal 5 koneksi per lokasi
-        const double MAX_DISTANCE = 2000; // Maksimal jarak koneksi langsung
-        
-        for (int i = 0; i < numLocations; i++) {
-            // Buat vector untuk menyimpan jarak ke semua titik lain
-            vector<pair<double, int>> distances;
-            
-            for (int j = 0; j < numLocations; j++) {
-                if (i != j) {
-                    double distance = calculateDistance(locations[i], locations[j]);
-                    distances.push_back({distance, j});
-                }
-            }
-            
-            // Urutkan berdasarkan jarak terdekat
-            sort(distances.begin(), distances.end());
-            
-            // Ambil maksimal MAX_CONNECTIONS titik terdekat
-            int connectionCount = 0;
-            for (auto& dist : distances) {
-                if (connectionCount >= MAX_CONNECTIONS) break;
-                if (dist.first > MAX_DISTANCE) break; // Jangan terlalu jauh
-                
-                graph[i].push_back(Edge(dist.second, dist.first));
-                connectionCount++;
-            }
-            
-            // Pastikan setiap lokasi minimal terhubung ke 2 titik terdekat
-            if (connectionCount < 2 && distances.size() >= 2) {
-                for (int k = connectionCount; k < min(2, (int)distances.size()); k++) {
-                    graph[i].push_back(Edge(distances[k].second, distances[k].first));
-                }
-            }
-        }
-        
-        // Tambahkan koneksi bidirectional untuk memastikan graf terhubung
-        ensureBidirectionalConnections();
-    }
-    
-    void ensureBidirectionalConnections() {
-        // Pastikan jika A terhubung ke B, maka B juga terhubung ke A
-        vector<vector<bool>> connected(numLocations, vector<bool>(numLocations, false));
-        
-        // Tandai koneksi yang sudah ada
-        for (int i = 0; i < numLocations; i++) {
-            for (const Edge& edge : graph[i]) {
-                connected[i][edge.to] = true;
-            }
-        }
-        
-        // Tambahkan koneksi balik jika belum ada
-        for (int i = 0; i < numLocations; i++) {
-            for (int j = 0; j < numLocations; j++) {
-                if (connected[i][j] && !connected[j][i]) {
-                    double distance = calculateDistance(locations[i], locations[j]);
-                    graph[j].push_back(Edge(i, distance));
-                    connected[j][i] = true;
-                }
-            }
-        }
+    // precomputed: tata letak yang sudah dihitung untuk lokasi network (misalnya graph bawaan);
+    // null berarti dihitung dari bounding box lokasi
+    explicit GoogleMapsSimulator(RoadNetwork& network, const ScreenLayout* precomputed = nullptr)
+        : network(network), renderer(network) {
+        screen = precomputed ? *precomputed : ScreenLayout::fit(network.locations, WINDOW_WIDTH, WINDOW_HEIGHT);
     }
     
+#if HAS_BGI
     void initializeGraphics() {
         // Perbesar ukuran window BGI
         initwindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Google Maps Simulator");
@@ -199,43 +125,44 @@ public:
         // Gambar koneksi jalan (edges) terlebih dahulu
         setcolor(LIGHTGRAY);
         setlinestyle(SOLID_LINE, 0, 1);
-        for (int i = 0; i < numLocations; i++) {
-            int x1 = toScreenX(locations[i].x);
-            int y1 = toScreenY(locations[i].y);
+        for (int i = 0; i < network.numLocations; i++) {
+            int x1 = screenX(i);
+            int y1 = screenY(i);
             
-            for (const Edge& edge : graph[i]) {
-                int x2 = toScreenX(locations[edge.to].x);
-                int y2 = toScreenY(locations[edge.to].y);
+            for (int e = network.graph.begin(i); e < network.graph.end(i); e++) {
+                int to = network.graph.targets[e];
+                int x2 = screenX(to);
+                int y2 = screenY(to);
                 line(x1, y1, x2, y2);
                 // Tampilkan label jarak di tengah edge, hanya sekali per edge
-                if (i < edge.to) {
+                if (i < to) {
                     settextstyle(DEFAULT_FONT, HORIZ_DIR, 2);
                     setcolor(WHITE);
                     int midX = (x1 + x2) / 2;
                     int midY = (y1 + y2) / 2;
                     char label[32];
-                    sprintf(label, "%.2f", edge.weight * UNIT_TO_KM);
+                    sprintf(label, "%.2f", toUnits(network.graph.weights[e]) * UNIT_TO_KM);
                     outtextxy(midX, midY, label);
                 }
             }
         }
         
         // Gambar lokasi di atas garis
-        for (int i = 0; i < numLocations; i++) {
-            int screenX = toScreenX(locations[i].x);
-            int screenY = toScreenY(locations[i].y);
+        for (int i = 0; i < network.numLocations; i++) {
+            int pointX = screenX(i);
+            int pointY = screenY(i);
             
             // Gambar titik lokasi
             setcolor(RED);
             setfillstyle(SOLID_FILL, RED);
-            fillellipse(screenX, screenY, 3, 3);
+            fillellipse(pointX, pointY, 3, 3);
             
             // Label nomor dan nama lokasi
             setcolor(WHITE);
             settextstyle(DEFAULT_FONT, HORIZ_DIR, 2); // Perbesar font angka
             char label[256];
-            sprintf(label, "%d. %s", i + 1, locations[i].name.c_str());
-            outtextxy(screenX + 10, screenY - 10, label);
+            sprintf(label, "%d. %s", i + 1, string(network.locations[i].name).c_str());
+            outtextxy(pointX + 10, pointY - 10, label);
             settextstyle(DEFAULT_FONT, HORIZ_DIR, 1); // Kembalikan font ke default
         }
         
@@ -266,10 +193,10 @@ public:
         setlinestyle(SOLID_LINE, 0, 3);
         
         for (int i = 0; i < path.size() - 1; i++) {
-            int x1 = toScreenX(locations[path[i]].x);
-            int y1 = toScreenY(locations[path[i]].y);
-            int x2 = toScreenX(locations[path[i + 1]].x);
-            int y2 = toScreenY(locations[path[i + 1]].y);
+            int x1 = screenX(path[i]);
+            int y1 = screenY(path[i]);
+            int x2 = screenX(path[i + 1]);
+            int y2 = screenY(path[i + 1]);
             
             line(x1, y1, x2, y2);
         }
@@ -277,80 +204,109 @@ public:
         // Highlight start and end points
         setcolor(GREEN);
         setfillstyle(SOLID_FILL, GREEN);
-        int startX = toScreenX(locations[path[0]].x);
-        int startY = toScreenY(locations[path[0]].y);
+        int startX = screenX(path[0]);
+        int startY = screenY(path[0]);
         fillellipse(startX, startY, 6, 6); // Perkecil titik awal
         
         setcolor(MAGENTA);
         setfillstyle(SOLID_FILL, MAGENTA);
-        int endX = toScreenX(locations[path.back()].x);
-        int endY = toScreenY(locations[path.back()].y);
+        int endX = screenX(path.back());
+        int endY = screenY(path.back());
         fillellipse(endX, endY, 6, 6); // Perkecil titik tujuan
         
         // Reset line style
         setlinestyle(SOLID_LINE, 0, 1);
     }
-    
+#else
+    // Pengganti drawMap + drawPath tanpa BGI: gambar seukuran window ke file PPM
+    bool writeMapImage(const string& filename, const vector<int>& path, const vector<string>& info) {
+        auto center = renderer.mapCenter();
+        Raster image = renderer.renderView(center.first, center.second,
+                                           renderer.zoomToFit(WINDOW_WIDTH, WINDOW_HEIGHT), WINDOW_WIDTH,
+                                           WINDOW_HEIGHT, path, info);
+        image.text(10, 10, "Google Maps Simulator v0.01  |  Peta Lokasi SMP", COLOR_TEXT, 3);
+        
+        // Legenda di kiri bawah seperti versi BGI
+        int legendY = WINDOW_HEIGHT - 140;
+        image.text(20, legendY, "Legenda:", COLOR_TEXT, 2);
+        image.fillCircle(20, legendY + 25, 6, COLOR_LOCATION);
+        image.text(35, legendY + 20, "Lokasi Penting", COLOR_TEXT, 2);
+        image.line(15, legendY + 50, 35, legendY + 50, COLOR_ROAD);
+        image.text(45, legendY + 45, "Jalan Penghubung", COLOR_TEXT, 2);
+        image.text(35, legendY + 70, "Jarak pada edge dalam satuan KM", COLOR_TEXT, 2);
+        
+        if (!image.writePpm(filename)) {
+            cout << "Gagal menulis " << filename << endl;
+            return false;
+        }
+        cout << "Gambar disimpan ke " << filename << " (" << WINDOW_WIDTH << "x" << WINDOW_HEIGHT
+             << ", tile dari cache: " << renderer.cacheHits() << ", digambar: " << renderer.cacheMisses() << ")"
+             << endl;
+        return true;
+    }
+#endif
+
     void displayLocations() {
         cout << "\n=== DAFTAR LOKASI PENTING DI SEKITAR SMP ===" << endl;
         cout << "--------------------------------------------" << endl;
-        for (int i = 0; i < numLocations; i++) {
-            cout << setw(2) << i + 1 << ". " << locations[i].name 
-                 << " (" << locations[i].x << ", " << locations[i].y << ")" << endl;
+        for (int i = 0; i < network.numLocations; i++) {
+            cout << setw(2) << i + 1 << ". " << network.locations[i].name 
+                 << " (" << network.locations[i].x << ", " << network.locations[i].y << ")";
+            if (network.isRemoved(i)) cout << " [dihapus]";
+            cout << endl;
         }
         cout << "\nTekan Enter untuk melanjutkan...";
         cin.ignore();
         cin.get();
     }
     
-    vector<int> dijkstra(int start, int end, vector<double>& distances) {
-        vector<double> dist(numLocations, numeric_limits<double>::infinity());
-        vector<int> prev(numLocations, -1);
-        vector<bool> visited(numLocations, false);
+    // Baca satu lokasi dari menu: nomor, koordinat "x,y" (lokasi terdekat) atau nama/awal nama.
+    // Jika nama cocok dengan beberapa lokasi, pengguna memilih dari daftar. -1 jika tidak valid.
+    // Baris dibaca tanpa membuang '\n' agar pola cin.ignore(); cin.get(); tetap berjalan.
+    int askLocation(const string& prompt) {
+        cout << prompt << " (nomor 1-" << network.numLocations << ", x,y, atau nama): ";
+        string input;
+        cin >> ws;
+        while (cin.peek() != '\n' && cin.peek() != EOF) input += (char)cin.get();
+        while (!input.empty() && isspace((unsigned char)input.back())) input.pop_back();
         
-        priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> pq;
-        
-        dist[start] = 0;
-        pq.push({0, start});
-        
-        while (!pq.empty()) {
-            double d = pq.top().first;
-            int u = pq.top().second;
-            pq.pop();
-            
-            if (visited[u]) continue;
-            visited[u] = true;
-            
-            if (u == end) break;
-            
-            for (const Edge& edge : graph[u]) {
-                int v = edge.to;
-                double weight = edge.weight;
-                
-                if (!visited[v] && dist[u] + weight < dist[v]) {
-                    dist[v] = dist[u] + weight;
-                    prev[v] = u;
-                    pq.push({dist[v], v});
-                }
+        int index = 0, x = 0, y = 0;
+        char extra;
+        if (sscanf(input.c_str(), "%d%c", &index, &extra) == 1) return index - 1;
+        if (sscanf(input.c_str(), "%d,%d%c", &x, &y, &extra) == 2 ||
+            sscanf(input.c_str(), "@%d,%d%c", &x, &y, &extra) == 2) {
+            double distance = 0;
+            int nearest = network.nearestLocation(x, y, &distance);
+            if (nearest >= 0) {
+                cout << "Lokasi terdekat dari (" << x << ", " << y << "): " << nearest + 1 << ". "
+                     << network.locations[nearest].name << " (" << fixed << setprecision(2)
+                     << distance * UNIT_TO_KM << " KM)" << endl;
             }
+            return nearest;
         }
         
-        distances = dist;
-        
-        vector<int> path;
-        int current = end;
-        while (current != -1) {
-            path.push_back(current);
-            current = prev[current];
+        const int MAX_CHOICES = 5;
+        vector<NameMatch> matches = network.findLocationsByName(input, MAX_CHOICES);
+        if (matches.empty()) {
+            cout << "Lokasi \"" << input << "\" tidak ditemukan." << endl;
+            return -1;
         }
-        
-        reverse(path.begin(), path.end());
-        
-        if (path.size() == 1 && path[0] != start) {
-            path.clear();
+        if (matches.size() == 1) {
+            int found = matches[0].location;
+            cout << "Dipilih: " << found + 1 << ". " << network.locations[found].name << endl;
+            return found;
         }
-        
-        return path;
+        cout << (matches[0].edits > 0 ? "Mungkin maksud Anda:" : "Beberapa lokasi cocok:") << endl;
+        for (size_t k = 0; k < matches.size(); k++) {
+            int i = matches[k].location;
+            cout << "  " << k + 1 << ". " << network.locations[i].name << " (" << network.locations[i].x
+                 << ", " << network.locations[i].y << ")" << endl;
+        }
+        cout << "Pilih (1-" << matches.size() << "): ";
+        int choice = 0;
+        cin >> choice;
+        if (choice < 1 || choice > (int)matches.size()) return -1;
+        return matches[choice - 1].location;
     }
     
     void showGraphicalPath() {
@@ -359,26 +315,26 @@ public:
         cout << "\n=== PENCARIAN JALUR TERPENDEK (GRAFIS) ===" << endl;
         displayLocations();
         
-        cout << "Masukkan nomor lokasi awal (1-" << numLocations << "): ";
-        cin >> start;
-        start--; 
+        start = askLocation("Masukkan lokasi awal");
+        end = askLocation("Masukkan lokasi tujuan");
         
-        cout << "Masukkan nomor lokasi tujuan (1-" << numLocations << "): ";
-        cin >> end;
-        end--; 
-        
-        if (start < 0 || start >= numLocations || end < 0 || end >= numLocations) {
+        if (start < 0 || start >= network.numLocations || end < 0 || end >= network.numLocations) {
             cout << "Nomor lokasi tidak valid!" << endl;
             return;
         }
         
+        if (network.isRemoved(start) || network.isRemoved(end)) {
+            cout << "Lokasi " << (network.isRemoved(start) ? start : end) + 1 << " sudah dihapus!" << endl;
+            return;
+        }
+        
         if (start == end) {
             cout << "Lokasi awal dan tujuan sama!" << endl;
             return;
         }
         
-        vector<double> distances;
-        vector<int> path = dijkstra(start, end, distances);
+        RouteResult route = network.findRoute(start, end);
+        const vector<int>& path = route.path;
         
         if (path.empty()) {
             cout << "\nTidak ada jalur yang ditemukan!" << endl;
@@ -391,11 +347,13 @@ public:
         
         // Tampilkan hasil di console
         cout << "\nJalur terpendek ditemukan!" << endl;
-        cout << "Jarak total: " << fixed << setprecision(2) << (distances[end] * UNIT_TO_KM) << " KM" << endl;
+        cout << "Jarak total: " << fixed << setprecision(2) << (route.distance * UNIT_TO_KM) << " KM" << endl;
         cout << "Jumlah titik yang dilalui: " << path.size() << " lokasi" << endl;
-        cout << "Dari: " << locations[start].name << endl;
-        cout << "Ke: " << locations[end].name << endl;
+        cout << "Simpul yang diproses (" << searchModeName(network.searchMode) << "): " << route.settledNodes << endl;
+        cout << "Dari: " << network.locations[start].name << endl;
+        cout << "Ke: " << network.locations[end].name << endl;
         cout << "\nJalur mengikuti jalan yang tersedia (bukan garis lurus)" << endl;
+#if HAS_BGI
         cout << "Membuka tampilan grafis..." << endl;
         
         // Tampilkan grafis
@@ -410,14 +368,16 @@ public:
         int baris = 0;
         int fontHeight = textheight(const_cast<char*>("A"));
         int infoX = WINDOW_WIDTH - 500; // Lebar blok keterangan
-        int infoY = WINDOW_HEIGHT - (fontHeight * 9) - 30; // 9 baris, 30px margin bawah
-        sprintf(info, "Jarak Total: %.2f KM", distances[end] * UNIT_TO_KM);
+        int infoY = WINDOW_HEIGHT - (fontHeight * 10) - 30; // 10 baris, 30px margin bawah
+        sprintf(info, "Jarak Total: %.2f KM", route.distance * UNIT_TO_KM);
         outtextxy(infoX, infoY + baris * fontHeight, info); baris++;
         sprintf(info, "Titik Dilalui: %d lokasi", (int)path.size());
         outtextxy(infoX, infoY + baris * fontHeight, info); baris++;
-        sprintf(info, "Dari: %s", locations[start].name.c_str());
+        sprintf(info, "Simpul Diproses: %d", route.settledNodes);
         outtextxy(infoX, infoY + baris * fontHeight, info); baris++;
-        sprintf(info, "Ke: %s", locations[end].name.c_str());
+        sprintf(info, "Dari: %s", string(network.locations[start].name).c_str());
+        outtextxy(infoX, infoY + baris * fontHeight, info); baris++;
+        sprintf(info, "Ke: %s", string(network.locations[end].name).c_str());
         outtextxy(infoX, infoY + baris * fontHeight, info); baris++;
         settextstyle(DEFAULT_FONT, HORIZ_DIR, 2); // Perbesar font keterangan berikut
         setcolor(YELLOW);
@@ -429,61 +389,90 @@ public:
         setcolor(WHITE);
         outtextxy(infoX, infoY + baris * fontHeight, const_cast<char*>("CATATAN: Jalur mengikuti jalan"));
         baris++;
-        outtextxy(infoX, infoY + baris * fontHeight, const_cast<char*>("tersedia dgn algo Dijkstra"));
+        sprintf(info, "tersedia dgn algo %s", searchModeName(network.searchMode));
+        outtextxy(infoX, infoY + baris * fontHeight, info);
         settextstyle(DEFAULT_FONT, HORIZ_DIR, 1); // Kembalikan font ke default
         
         getch();
         closegraph();
+#else
+        cout << "Tampilan grafis BGI tidak tersedia; peta dan jalur digambar ke file." << endl;
+        char info[150];
+        vector<string> lines;
+        snprintf(info, sizeof(info), "Jarak Total: %.2f KM", route.distance * UNIT_TO_KM);
+        lines.push_back(info);
+        snprintf(info, sizeof(info), "Titik Dilalui: %d lokasi", (int)path.size());
+        lines.push_back(info);
+        snprintf(info, sizeof(info), "Simpul Diproses: %d", route.settledNodes);
+        lines.push_back(info);
+        lines.push_back("Dari: " + string(network.locations[start].name));
+        lines.push_back("Ke: " + string(network.locations[end].name));
+        writeMapImage("jalur.ppm", path, lines);
+        cout << "Tekan Enter untuk melanjutkan...";
+        cin.ignore();
+        cin.get();
+#endif
     }
     
     void showGraphicalMap() {
+#if HAS_BGI
         cout << "\nMembuka peta grafis..." << endl;
         initializeGraphics();
         drawMap();
         getch();
         closegraph();
+#else
+        cout << "\nTampilan grafis BGI tidak tersedia; peta digambar ke file." << endl;
+        writeMapImage("peta.ppm", vector<int>(), vector<string>());
+#endif
     }
     
     void findShortestPath() {
         int start, end;
         
         cout << "\n=== PENCARIAN JALUR TERPENDEK ===" << endl;
-        cout << "Masukkan nomor lokasi awal (1-" << numLocations << "): ";
-        cin >> start;
-        start--; 
-        
-        cout << "Masukkan nomor lokasi tujuan (1-" << numLocations << "): ";
-        cin >> end;
-        end--; 
+        start = askLocation("Masukkan lokasi awal");
+        end = askLocation("Masukkan lokasi tujuan");
         
-        if (start < 0 || start >= numLocations || end < 0 || end >= numLocations) {
+        if (start < 0 || start >= network.numLocations || end < 0 || end >= network.numLocations) {
             cout << "Nomor lokasi tidak valid!" << endl;
             return;
         }
         
+        if (network.isRemoved(start) || network.isRemoved(end)) {
+            cout << "Lokasi " << (network.isRemoved(start) ? start : end) + 1 << " sudah dihapus!" << endl;
+            return;
+        }
+        
         if (start == end) {
             cout << "Lokasi awal dan tujuan sama!" << endl;
             return;
         }
         
-        cout << "\nMencari jalur terpendek dari " << locations[start].name 
-             << " ke " << locations[end].name << "..." << endl;
-        cout << "Menggunakan algoritma Dijkstra dengan koneksi realistis..." << endl;
+        cout << "\nMencari jalur terpendek dari " << network.locations[start].name 
+             << " ke " << network.locations[end].name << "..." << endl;
+        cout << "Menggunakan algoritma " << searchModeName(network.searchMode) << " dengan koneksi realistis..." << endl;
         
-        vector<double> distances;
-        vector<int> path = dijkstra(start, end, distances);
+        RouteResult route = network.findRoute(start, end);
+        const vector<int>& path = route.path;
         
         if (!path.empty()) {
             cout << "\n=== JALUR TERPENDEK DITEMUKAN ===" << endl;
-            cout << "Jarak total: " << fixed << setprecision(2) << (distances[end] * UNIT_TO_KM) << " KM" << endl;
+            cout << "Jarak total: " << fixed << setprecision(2) << (route.distance * UNIT_TO_KM) << " KM" << endl;
             cout << "Jumlah lokasi yang dilalui: " << path.size() << " titik" << endl;
+            cout << "Simpul yang diproses: " << route.settledNodes << endl;
+#if MAPS_INSTRUMENTATION
+            cout << "Heap push: " << route.counters.heapPushes << ", pop basi: " << route.counters.stalePops()
+                 << ", edge diperiksa: " << route.counters.relaxations
+                 << ", waktu: " << fixed << setprecision(1) << route.micros << " us" << endl;
+#endif
             cout << "Jalur yang dilalui:" << endl;
             
             double totalDistance = 0;
             for (int i = 0; i < path.size(); i++) {
-                cout << (i + 1) << ". " << locations[path[i]].name;
+                cout << (i + 1) << ". " << network.locations[path[i]].name;
                 if (i < path.size() - 1) {
-                    double segmentDistance = calculateDistance(locations[path[i]], locations[path[i + 1]]);
+                    double segmentDistance = network.calculateDistance(network.locations[path[i]], network.locations[path[i + 1]]);
                     totalDistance += segmentDistance;
                     cout << "\n   -> Jarak ke titik berikutnya: " << fixed << setprecision(2) << (segmentDistance * UNIT_TO_KM) << " KM";
                 }
@@ -494,10 +483,10 @@ public:
             cout << "         tidak menggunakan garis lurus langsung." << endl;
             
             // Tampilkan koneksi langsung yang tersedia dari titik awal
-            cout << "\nKoneksi langsung dari " << locations[start].name << ":" << endl;
-            for (const Edge& edge : graph[start]) {
-                cout << "  - " << locations[edge.to].name 
-                     << " (jarak: " << fixed << setprecision(2) << (edge.weight * UNIT_TO_KM) << " KM)" << endl;
+            cout << "\nKoneksi langsung dari " << network.locations[start].name << ":" << endl;
+            for (int e = network.graph.begin(start); e < network.graph.end(start); e++) {
+                cout << "  - " << network.locations[network.graph.targets[e]].name 
+                     << " (jarak: " << fixed << setprecision(2) << (toUnits(network.graph.weights[e]) * UNIT_TO_KM) << " KM)" << endl;
             }
             
         } else {
@@ -507,13 +496,13 @@ public:
             cout << "2. Jarak terlalu jauh untuk koneksi langsung" << endl;
             
             // Tampilkan koneksi yang tersedia
-            cout << "\nKoneksi yang tersedia dari " << locations[start].name << ":" << endl;
-            if (graph[start].empty()) {
+            cout << "\nKoneksi yang tersedia dari " << network.locations[start].name << ":" << endl;
+            if (network.graph.degree(start) == 0) {
                 cout << "  - Tidak ada koneksi langsung" << endl;
             } else {
-                for (const Edge& edge : graph[start]) {
-                    cout << "  - " << locations[edge.to].name 
-                         << " (jarak: " << fixed << setprecision(2) << (edge.weight * UNIT_TO_KM) << " KM)" << endl;
+                for (int e = network.graph.begin(start); e < network.graph.end(start); e++) {
+                    cout << "  - " << network.locations[network.graph.targets[e]].name 
+                         << " (jarak: " << fixed << setprecision(2) << (toUnits(network.graph.weights[e]) * UNIT_TO_KM) << " KM)" << endl;
                 }
             }
         }
@@ -528,25 +517,42 @@ public:
         cout << "Menampilkan koneksi jalan yang tersedia dari setiap lokasi" << endl;
         cout << "=========================================================" << endl;
         
-        for (int i = 0; i < numLocations; i++) {
-            cout << "\n" << (i + 1) << ". " << locations[i].name << endl;
-            cout << "   Koordinat: (" << locations[i].x << ", " << locations[i].y << ")" << endl;
+        // Nomori komponen sesuai urutan lokasi pertamanya; lokasi yang dihapus tidak dihitung
+        network.refreshComponents();
+        map<int, int> componentNumber; // Akar union-find -> nomor tampilan
+        vector<pair<int, int>> componentSizes; // (ukuran, nomor)
+        for (int i = 0; i < network.numLocations; i++) {
+            if (network.isRemoved(i)) continue;
+            int root = network.components.componentOf(i);
+            if (componentNumber.count(root)) continue;
+            int number = componentNumber.size() + 1;
+            componentNumber[root] = number;
+            componentSizes.push_back({network.components.componentSize(i), number});
+        }
+        
+        for (int i = 0; i < network.numLocations; i++) {
+            cout << "\n" << (i + 1) << ". " << network.locations[i].name << endl;
+            cout << "   Koordinat: (" << network.locations[i].x << ", " << network.locations[i].y << ")" << endl;
+            if (!network.isRemoved(i)) {
+                cout << "   Komponen: #" << componentNumber[network.components.componentOf(i)]
+                     << " (" << network.components.componentSize(i) << " lokasi)" << endl;
+            }
             cout << "   Terhubung langsung ke:" << endl;
             
-            if (graph[i].empty()) {
+            if (network.graph.degree(i) == 0) {
                 cout << "   - Tidak ada koneksi langsung" << endl;
             } else {
                 // Urutkan koneksi berdasarkan jarak
                 vector<pair<double, int>> sortedConnections;
-                for (const Edge& edge : graph[i]) {
-                    sortedConnections.push_back({edge.weight, edge.to});
+                for (int e = network.graph.begin(i); e < network.graph.end(i); e++) {
+                    sortedConnections.push_back({toUnits(network.graph.weights[e]), network.graph.targets[e]});
                 }
                 sort(sortedConnections.begin(), sortedConnections.end());
                 
                 for (int j = 0; j < sortedConnections.size(); j++) {
                     int targetIndex = sortedConnections[j].second;
                     double distance = sortedConnections[j].first;
-                    cout << "   " << (j + 1) << ") " << locations[targetIndex].name 
+                    cout << "   " << (j + 1) << ") " << network.locations[targetIndex].name 
                          << " (jarak: " << fixed << setprecision(2) << (distance * UNIT_TO_KM) << " KM)" << endl;
                 }
             }
@@ -557,14 +563,163 @@ public:
         cout << "- Setiap lokasi hanya terhubung dengan maksimal 5 lokasi terdekat" << endl;
         cout << "- Jarak maksimal koneksi langsung: 2000 unit" << endl;
         cout << "- Ini mensimulasikan jaringan jalan yang realistis" << endl;
+        cout << "- Edge balik yang ditambahkan agar jalan dua arah: " << network.symmetrizeStats.added << endl;
+        cout << "- Edge ganda yang dibuang: " << network.symmetrizeStats.duplicates << endl;
+        if (network.symmetrizeStats.tooLong > 0) {
+            cout << "- Koneksi yang tidak dibuat karena terlalu panjang: " << network.symmetrizeStats.tooLong << endl;
+        }
         cout << "- Untuk mencapai lokasi yang tidak terhubung langsung," << endl;
         cout << "  harus melewati lokasi perantara" << endl;
         
+        // Komponen terbesar dulu; query antar komponen berbeda langsung ditolak tanpa pencarian
+        stable_sort(componentSizes.begin(), componentSizes.end(),
+                    [](const pair<int, int>& a, const pair<int, int>& b) { return a.first > b.first; });
+        cout << "\nKomponen terhubung: " << componentSizes.size() << endl;
+        for (const auto& c : componentSizes) {
+            cout << "- Komponen #" << c.second << ": " << c.first << " lokasi" << endl;
+        }
+        if (componentSizes.size() > 1) {
+            cout << "Lokasi di komponen berbeda tidak memiliki rute sama sekali." << endl;
+        }
+        
+        cout << "\nTekan Enter untuk melanjutkan...";
+        cin.ignore();
+        cin.get();
+    }
+    
+    void chooseSearchMode() {
+        cout << "\n=== ALGORITMA PENCARIAN ===" << endl;
+        for (int m = 0; m < SEARCH_MODE_COUNT; m++) {
+            cout << (m + 1) << ". " << searchModeName((SearchMode)m) << endl;
+        }
+        cout << "Pilih algoritma (1-" << SEARCH_MODE_COUNT << "): ";
+        int choice;
+        cin >> choice;
+        if (choice < 1 || choice > SEARCH_MODE_COUNT) {
+            cout << "Pilihan tidak valid!" << endl;
+            return;
+        }
+        network.searchMode = (SearchMode)(choice - 1);
+        if (network.searchMode == MODE_CONTRACTION_HIERARCHIES && !network.hierarchy.isBuilt()) {
+            cout << "Membangun Contraction Hierarchies..." << endl;
+            if (network.prepareSearchMode()) {
+                cout << "Selesai, " << network.hierarchy.shortcuts() << " shortcut ditambahkan." << endl;
+            } else {
+                cout << network.hierarchy.error() << endl;
+            }
+        }
+        cout << "Algoritma pencarian: " << searchModeName(network.searchMode) << endl;
+    }
+    
+    void showSearchStats() {
+        cout << "\n=== STATISTIK PENCARIAN SESI INI ===" << endl;
+#if MAPS_INSTRUMENTATION
+        if (network.sessionStats.queries() == 0) {
+            cout << "Belum ada query yang dijalankan." << endl;
+        } else {
+            network.sessionStats.print(cout);
+        }
+#else
+        cout << "Instrumentasi tidak ikut dikompilasi (MAPS_INSTRUMENTATION=0)." << endl;
+#endif
+        if (network.treeCache.capacity() > 0) {
+            const double MB = 1 << 20;
+            const PathTreeCache& cache = network.treeCache;
+            cout << "\nCache pohon jalur terpendek: " << cache.size() << "/" << cache.capacity() << " lokasi awal, "
+                 << fixed << setprecision(1) << cache.bytesUsed() / MB << "/" << cache.byteCapacity() / MB << " MB, "
+                 << cache.hits() << " hit, " << cache.misses() << " miss" << endl;
+            if (!cache.usable(network.numLocations)) {
+                cout << "Cache tidak dipakai: satu pohon (" << ShortestPathTree::bytesFor(network.numLocations) / MB
+                     << " MB) melebihi batas memori" << endl;
+            }
+        }
+        
         cout << "\nTekan Enter untuk melanjutkan...";
         cin.ignore();
         cin.get();
     }
     
+    void planMultiStopRoute() {
+        cout << "\n=== RUTE BANYAK TUJUAN ===" << endl;
+        cout << "Masukkan semua lokasi dalam satu baris, dipisah spasi (nomor, @x,y atau \"nama\")." << endl;
+        cout << "Lokasi pertama adalah titik berangkat: ";
+        string input;
+        cin >> ws;
+        while (cin.peek() != '\n' && cin.peek() != EOF) input += (char)cin.get();
+        
+        vector<int> stops;
+        size_t pos = 0;
+        string token, error;
+        while (nextEndpoint(input, pos, token)) {
+            int location = resolveEndpoint(network, token, error);
+            if (location < 0) {
+                cout << "Lokasi tidak valid (" << error << "): " << token << endl;
+                return;
+            }
+            stops.push_back(location);
+        }
+        if (stops.size() < 2) {
+            cout << "Butuh minimal 2 lokasi!" << endl;
+            return;
+        }
+        
+        TourOptions options;
+        cout << "Kembali ke titik berangkat setelah tujuan terakhir? (y/n): ";
+        char answer = 'n';
+        cin >> answer;
+        options.returnToStart = answer == 'y' || answer == 'Y';
+        TourPlan plan = planTour(network, stops, options);
+        if (!plan.error.empty()) {
+            cout << "Rute tidak bisa dibuat: " << plan.error << endl;
+            return;
+        }
+        
+        cout << "\nUrutan kunjungan:" << endl;
+        for (size_t k = 0; k < plan.order.size(); k++) {
+            cout << setw(3) << k + 1 << ". " << network.locations[plan.order[k]].name;
+            if (k < plan.legs.size()) {
+                cout << "\n     -> " << fixed << setprecision(2) << plan.legs[k] * UNIT_TO_KM << " KM";
+            }
+            cout << endl;
+        }
+        cout << "Jarak total: " << fixed << setprecision(2) << plan.distance * UNIT_TO_KM << " KM (urutan awal "
+             << plan.initialDistance * UNIT_TO_KM << " KM)" << endl;
+        cout << "Jalur lengkap melewati " << plan.path.size() << " titik; " << plan.rounds << " putaran perbaikan, "
+             << setprecision(1) << plan.tableMs + plan.optimizeMs + plan.stitchMs << " ms" << endl;
+#if HAS_BGI
+        cout << "Membuka tampilan grafis..." << endl;
+        initializeGraphics();
+        drawMap();
+        drawPath(plan.path);
+        // Nomor urut kunjungan di samping setiap lokasi tujuan
+        settextstyle(DEFAULT_FONT, HORIZ_DIR, 2);
+        setcolor(YELLOW);
+        char label[32];
+        for (size_t k = 1; k < plan.order.size(); k++) {
+            sprintf(label, "#%d", (int)k);
+            outtextxy(screenX(plan.order[k]) - 30, screenY(plan.order[k]) + 8, label);
+        }
+        sprintf(label, "Jarak Total: %.2f KM", plan.distance * UNIT_TO_KM);
+        outtextxy(WINDOW_WIDTH - 500, WINDOW_HEIGHT - 60, label);
+        settextstyle(DEFAULT_FONT, HORIZ_DIR, 1);
+        getch();
+        closegraph();
+#else
+        cout << "Tampilan grafis BGI tidak tersedia; peta dan rute digambar ke file." << endl;
+        char info[150];
+        vector<string> lines;
+        snprintf(info, sizeof(info), "Jarak Total: %.2f KM", plan.distance * UNIT_TO_KM);
+        lines.push_back(info);
+        snprintf(info, sizeof(info), "Tujuan: %d lokasi", (int)plan.order.size() - 1);
+        lines.push_back(info);
+        lines.push_back("Berangkat: " + string(network.locations[plan.order[0]].name));
+        writeMapImage("rute.ppm", plan.path, lines);
+#endif
+        cout << "Tekan Enter untuk melanjutkan...";
+        cin.ignore();
+        cin.get();
+    }
+    
     void run() {
         int choice;
         
@@ -581,8 +736,11 @@ public:
             cout << "3. Cari jalur terpendek (teks)" << endl;
             cout << "4. Cari jalur terpendek (grafis)" << endl;
             cout << "5. Lihat koneksi jalan per lokasi" << endl;
-            cout << "6. Keluar" << endl;
-            cout << "Pilih menu (1-6): ";
+            cout << "6. Pilih algoritma pencarian (sekarang: " << searchModeName(network.searchMode) << ")" << endl;
+            cout << "7. Statistik pencarian" << endl;
+            cout << "8. Rute banyak tujuan (urutan kunjungan terbaik)" << endl;
+            cout << "9. Keluar" << endl;
+            cout << "Pilih menu (1-9): ";
             cin >> choice;
             
             switch (choice) {
@@ -602,21 +760,544 @@ public:
                     showRoadConnections();
                     break;
                 case 6:
+                    chooseSearchMode();
+                    break;
+                case 7:
+                    showSearchStats();
+                    break;
+                case 8:
+                    planMultiStopRoute();
+                    break;
+                case 9:
                     cout << "\nTerima kasih telah menggunakan Google Maps Simulator!" << endl;
                     cout << "Program dibuat dengan algoritma Dijkstra untuk tugas SMP." << endl;
                     cout << "Fitur: Jalur realistis mengikuti jalan tersedia" << endl;
                     cout << "Deadline: 8 Juni 2025" << endl;
                     return;
                 default:
-                    cout << "Pilihan tidak valid! Silakan pilih 1-6." << endl;
+                    cout << "Pilihan tidak valid! Silakan pilih 1-9." << endl;
                     break;
             }
         }
     }
 };
 
-int main() {
-    GoogleMapsSimulator simulator;
+// Baca daftar asal dan tujuan dari file (baris 1: nomor lokasi asal, baris 2: nomor lokasi
+// tujuan, dipisah spasi, mulai dari 1), lalu cetak matriks jarak dalam KM, satu baris per asal
+int runDistanceMatrix(RoadNetwork& network, const string& filename, int threads) {
+    ifstream in(filename);
+    if (!in) {
+        cerr << "File tidak bisa dibuka: " << filename << endl;
+        return 1;
+    }
+    
+    vector<int> lists[2];
+    string line;
+    for (int k = 0; k < 2 && getline(in, line); k++) {
+        istringstream items(line);
+        int number;
+        while (items >> number) {
+            if (number < 1 || number > network.numLocations) {
+                cerr << "Nomor lokasi tidak valid: " << number << endl;
+                return 1;
+            }
+            lists[k].push_back(number - 1);
+        }
+    }
+    if (lists[0].empty() || lists[1].empty()) {
+        cerr << "Format file: baris 1 = lokasi asal, baris 2 = lokasi tujuan" << endl;
+        return 1;
+    }
+    
+    vector<double> matrix = network.distanceMatrix(lists[0], lists[1], threads);
+    cout << fixed << setprecision(3);
+    for (size_t i = 0; i < lists[0].size(); i++) {
+        for (size_t j = 0; j < lists[1].size(); j++) {
+            double d = matrix[i * lists[1].size() + j];
+            if (j > 0) cout << ' ';
+            if (isinf(d)) cout << "inf";
+            else cout << d * UNIT_TO_KM;
+        }
+        cout << '\n';
+    }
+    return 0;
+}
+
+// Isochrone: semua lokasi yang bisa dicapai dalam km dari satu atau beberapa lokasi (dipisah
+// spasi, format ujung seperti --batch). Satu baris JSON per lokasi, urut jarak, ditulis langsung
+// saat lokasi ditemukan; ringkasan ke stderr.
+int runIsochrone(RoadNetwork& network, const string& sourceList, double km) {
+    vector<int> sources;
+    size_t pos = 0;
+    string token, error;
+    while (nextEndpoint(sourceList, pos, token)) {
+        int location = resolveEndpoint(network, token, error);
+        if (location < 0) {
+            cerr << error << ": " << token << endl;
+            return 1;
+        }
+        sources.push_back(location);
+    }
+    if (sources.empty()) {
+        cerr << "--isochrone butuh minimal satu lokasi" << endl;
+        return 1;
+    }
+    
+    auto began = chrono::steady_clock::now();
+    static thread_local SearchContext ctx;
+    char line[128];
+    int found = network.reachableWithin(sources, km / UNIT_TO_KM, ctx, [&](int location, double distance, int source) {
+        snprintf(line, sizeof(line), "{\"location\":%d,\"distance_km\":%.3f,\"source\":%d}\n", location + 1,
+                 distance * UNIT_TO_KM, source + 1);
+        cout << line;
+    });
+    cout.flush();
+    cerr << found << " lokasi dalam " << km << " km dari " << sources.size() << " lokasi awal, " << fixed
+         << setprecision(2) << chrono::duration<double, milli>(chrono::steady_clock::now() - began).count() << " ms"
+         << endl;
+    return 0;
+}
+
+// Rute banyak tujuan dari daftar lokasi (format ujung seperti --batch, lokasi pertama = awal):
+// satu baris JSON berisi urutan kunjungan, jarak tiap kaki dan jalur lengkap; waktu ke stderr
+int runTour(RoadNetwork& network, const string& stopList, const TourOptions& options) {
+    vector<int> stops;
+    size_t pos = 0;
+    string token, error;
+    while (nextEndpoint(stopList, pos, token)) {
+        int location = resolveEndpoint(network, token, error);
+        if (location < 0) {
+            cerr << error << ": " << token << endl;
+            return 1;
+        }
+        stops.push_back(location);
+    }
+    TourPlan plan = planTour(network, stops, options);
+    if (!plan.error.empty()) {
+        cerr << "Rute tidak bisa dibuat: " << plan.error << endl;
+        return 1;
+    }
+    
+    char number[64];
+    string json = "{\"stops\":" + to_string(plan.order.size() - (options.returnToStart && plan.order.size() > 1));
+    snprintf(number, sizeof(number), ",\"distance_km\":%.3f,\"initial_km\":%.3f", plan.distance * UNIT_TO_KM,
+             plan.initialDistance * UNIT_TO_KM);
+    json += number;
+    json += ",\"order\":[";
+    for (size_t k = 0; k < plan.order.size(); k++) {
+        json += (k > 0 ? "," : "") + to_string(plan.order[k] + 1);
+    }
+    json += "],\"legs_km\":[";
+    for (size_t k = 0; k < plan.legs.size(); k++) {
+        snprintf(number, sizeof(number), "%s%.3f", k > 0 ? "," : "", plan.legs[k] * UNIT_TO_KM);
+        json += number;
+    }
+    json += "],\"path\":[";
+    for (size_t k = 0; k < plan.path.size(); k++) {
+        json += (k > 0 ? "," : "") + to_string(plan.path[k] + 1);
+    }
+    json += "]}";
+    cout << json << endl;
+    cerr << "Tabel jarak " << fixed << setprecision(1) << plan.tableMs << " ms, optimasi " << plan.optimizeMs
+         << " ms (" << plan.rounds << " putaran), jalur " << plan.stitchMs << " ms" << endl;
+    return 0;
+}
+
+struct RenderOptions {
+    string imageFile, tilesDir;
+    int zoom = -1;                 // -1: seluruh peta muat di gambar
+    bool hasCenter = false;
+    double centerX = 0, centerY = 0;
+    int width = 1920, height = 1080;
+    int routeStart = -1, routeEnd = -1;
+};
+
+// Gambar peta tanpa BGI: satu gambar (--render) dan/atau semua tile satu level zoom (--tiles)
+int runRender(RoadNetwork& network, const RenderOptions& options) {
+    MapRenderer renderer(network);
+    auto began = chrono::steady_clock::now();
+    int zoom = options.zoom >= 0 ? options.zoom : renderer.zoomToFit(options.width, options.height);
+    
+    if (!options.tilesDir.empty()) {
+        if (zoom > 10) {
+            cerr << "--tiles dibatasi sampai zoom 10 (4^zoom tile)" << endl;
+            return 1;
+        }
+        string error;
+        int written = renderer.writeTiles(options.tilesDir, zoom, error);
+        if (!error.empty()) {
+            cerr << error << endl;
+            return 1;
+        }
+        cerr << written << " tile zoom " << zoom << " ditulis ke " << options.tilesDir << endl;
+    }
+    if (!options.imageFile.empty()) {
+        vector<int> path;
+        if (options.routeStart >= 0) {
+            if (options.routeStart >= network.numLocations || options.routeEnd < 0 ||
+                options.routeEnd >= network.numLocations) {
+                cerr << "Nomor lokasi --route tidak valid" << endl;
+                return 1;
+            }
+            path = network.findRoute(options.routeStart, options.routeEnd).path;
+            if (path.empty()) cerr << "Tidak ada jalur antara kedua lokasi" << endl;
+        }
+        auto center = renderer.mapCenter();
+        if (options.hasCenter) center = {options.centerX, options.centerY};
+        Raster image = renderer.renderView(center.first, center.second, zoom, options.width, options.height, path);
+        if (!image.writePpm(options.imageFile)) {
+            cerr << "Gagal menulis " << options.imageFile << endl;
+            return 1;
+        }
+    }
+    cerr << "Render zoom " << zoom << ": " << renderer.cacheMisses() << " tile digambar, " << renderer.cacheHits()
+         << " dari cache, " << fixed << setprecision(1)
+         << chrono::duration<double, milli>(chrono::steady_clock::now() - began).count() << " ms" << endl;
+    return 0;
+}
+
+// Terapkan perubahan jaringan dari file, satu perintah per baris (nomor lokasi mulai dari 1):
+//   add <x> <y> <nama>   remove <lokasi>   close <a> <b>   reopen <a> <b>   reweight <a> <b> <km>
+// Baris yang gagal dilaporkan lalu dilewati; nilai balik 1 jika ada yang gagal.
+int applyGraphUpdates(RoadNetwork& network, const string& filename) {
+    ifstream in(filename);
+    if (!in) {
+        cerr << "File tidak bisa dibuka: " << filename << endl;
+        return 1;
+    }
+    
+    auto began = chrono::steady_clock::now();
+    int applied = 0, failed = 0, lineNumber = 0;
+    string line;
+    while (getline(in, line)) {
+        lineNumber++;
+        istringstream items(line);
+        string command;
+        if (!(items >> command) || command[0] == '#') continue;
+        
+        // parsed = baris sesuai format; ok = perubahan berhasil diterapkan
+        bool parsed = true, ok = false;
+        int a = 0, b = 0, x = 0, y = 0;
+        double km = 0;
+        if (command == "add" && items >> x >> y) {
+            string name;
+            getline(items >> ws, name);
+            network.addLocation(x, y, name);
+            ok = true;
+        } else if (command == "remove" && items >> a) {
+            ok = network.removeLocation(a - 1);
+        } else if (command == "close" && items >> a >> b) {
+            ok = network.closeEdge(a - 1, b - 1);
+        } else if (command == "reopen" && items >> a >> b) {
+            ok = network.reopenEdge(a - 1, b - 1);
+        } else if (command == "reweight" && items >> a >> b >> km) {
+            ok = network.reweightEdge(a - 1, b - 1, km / UNIT_TO_KM);
+        } else {
+            parsed = false;
+        }
+        
+        if (ok) {
+            applied++;
+        } else {
+            failed++;
+            cerr << filename << ":" << lineNumber << ": " << (parsed ? network.updateError() : "Perintah tidak valid")
+                 << ": " << line << endl;
+        }
+    }
+    cerr << "Pembaruan jaringan: " << applied << " berhasil, " << failed << " gagal, "
+         << fixed << setprecision(2) << chrono::duration<double, milli>(chrono::steady_clock::now() - began).count()
+         << " ms" << endl;
+    return failed > 0 ? 1 : 0;
+}
+
+// Isi builtin_graph.h untuk network: tabel komponen per simpul dan koordinat layar dihitung di
+// sini, jadi graph yang dibangun saat runtime dan graph bawaan bisa dibandingkan sebagai teks
+string builtinGraphSource(const RoadNetwork& network, const ScreenLayout& screen) {
+    int n = network.numLocations;
+    vector<int32_t> roots(n), sizes(n), screenXs(n), screenYs(n);
+    for (int v = 0; v < n; v++) {
+        roots[v] = network.components.componentOf(v);
+        sizes[v] = network.components.componentSize(v);
+        screenXs[v] = screen.toScreenX(network.locations.xs[v]);
+        screenYs[v] = screen.toScreenY(network.locations.ys[v]);
+    }
+    ostringstream out;
+    writeEmbeddedGraph(out, network.locations, network.graph, roots, sizes, network.symmetrizeStats.added,
+                       network.symmetrizeStats.duplicates, screen, screenXs, screenYs);
+    return out.str();
+}
+
+// --generate-builtin / --check-builtin: bangun graph defaultLocations() seperti biasa, lalu tulis
+// sebagai builtin_graph.h atau pastikan tabel yang sudah dikompilasi masih sama persis
+int runBuiltinGraph(const string& outputFile, int threads) {
+    RoadNetwork built(defaultLocations(), threads);
+    string expected = builtinGraphSource(built, ScreenLayout::fit(built.locations, MAP_WINDOW_WIDTH,
+                                                                  MAP_WINDOW_HEIGHT));
+    if (!outputFile.empty()) {
+        ofstream out(outputFile, ios::binary);
+        out << expected;
+        if (!out) {
+            cerr << "Gagal menulis " << outputFile << endl;
+            return 1;
+        }
+        cerr << "Graph bawaan ditulis ke " << outputFile << ": " << built.numLocations << " lokasi, "
+             << built.graph.numEdges() << " edge" << endl;
+        return 0;
+    }
+    
+    const EmbeddedGraph& embedded = builtinGraph();
+    RoadNetwork compiled(embedded);
+    ScreenLayout screen = embedded.screen;
+    screen.xs = screen.ys = nullptr;
+    string actual = builtinGraphSource(compiled, screen);
+    // Koordinat layar yang tersimpan harus sama dengan hasil hitung ulang dari tata letaknya
+    bool screenMatches = true;
+    for (int v = 0; v < embedded.nodeCount; v++) {
+        if (embedded.screen.xs[v] != screen.toScreenX(embedded.xs[v]) ||
+            embedded.screen.ys[v] != screen.toScreenY(embedded.ys[v])) {
+            screenMatches = false;
+        }
+    }
+    if (actual == expected && screenMatches) {
+        cout << "builtin_graph.h OK: " << embedded.nodeCount << " lokasi, " << embedded.edgeCount << " edge" << endl;
+        return 0;
+    }
+    
+    // Tunjukkan baris pertama yang berbeda
+    istringstream a(expected), b(actual);
+    string lineA, lineB;
+    int lineNumber = 0;
+    while (getline(a, lineA)) {
+        lineNumber++;
+        if (!getline(b, lineB) || lineA != lineB) break;
+    }
+    cout << "builtin_graph.h TIDAK SAMA dengan graph runtime (jalankan `make builtin`)" << endl;
+    if (actual != expected) {
+        cout << "  baris " << lineNumber << " seharusnya: " << lineA << endl
+             << "  baris " << lineNumber << " tersimpan:  " << lineB << endl;
+    } else {
+        cout << "  koordinat layar tidak cocok dengan tata letak" << endl;
+    }
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    // Mode non-interaktif:
+    //   main2 --matrix <file> [--threads N] [--mode M]
+    //   main2 --batch [file|-] [--threads N] [--mode M] [--stats] [--tree-cache K] [--tree-cache-mb M]
+    //   main2 --save-graph <file> [--mode ch]               (simpan graph biner lalu keluar)
+    //   main2 --graph <file> [--verify] ...                 (pakai graph biner via mmap)
+    //   main2 --import <file.csv> ...                       (lokasi dari CSV "x,y,nama")
+    //   main2 --updates <file> ...                          (ubah jaringan sebelum mode lain berjalan)
+    //   main2 --isochrone "<lokasi...>" --within <km>      (lokasi yang terjangkau, JSON per baris)
+    //   main2 --serve <socket> [--threads N] [--mode M]   (server query, lihat query_server.h)
+    //   main2 --tour "<lokasi...>" [--return] [--tour-ms MS]  (urutan kunjungan terbaik, JSON)
+    //   main2 --generate-builtin <file> | --check-builtin   (tulis/periksa builtin_graph.h)
+    //   main2 --render <file.ppm> [--tiles dir] [--zoom Z] [--center x,y] [--size WxH] [--route a,b]
+    string matrixFile, batchFile, graphFile, saveGraphFile, importFile, updatesFile, socketPath, isochroneSources;
+    string builtinFile, tourStops;
+    TourOptions tour;
+    bool batch = false, verify = false, stats = false, checkBuiltin = false;
+    int threads = 0;
+    double withinKm = -1;
+    int treeCacheEntries = -1; // -1: default (mati di mode batch, aktif di menu)
+    double treeCacheMb = -1;   // -1: PathTreeCache::DEFAULT_BYTES
+    SearchMode mode = MODE_DIJKSTRA;
+    RenderOptions render;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--matrix" && i + 1 < argc) {
+            matrixFile = argv[++i];
+        } else if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') batchFile = argv[++i];
+            else if (i + 1 < argc && string(argv[i + 1]) == "-") i++;
+        } else if (arg == "--serve" && i + 1 < argc) {
+            if (!HAS_QUERY_SERVER) {
+                cerr << "--serve hanya tersedia di Linux" << endl;
+                return 1;
+            }
+            socketPath = argv[++i];
+        } else if (arg == "--isochrone" && i + 1 < argc) {
+            isochroneSources = argv[++i];
+        } else if (arg == "--tour" && i + 1 < argc) {
+            tourStops = argv[++i];
+        } else if (arg == "--return") {
+            tour.returnToStart = true;
+        } else if (arg == "--tour-ms" && i + 1 < argc) {
+            tour.budgetMs = max(0.0, atof(argv[++i]));
+        } else if (arg == "--within" && i + 1 < argc) {
+            withinKm = atof(argv[++i]);
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = atoi(argv[++i]);
+        } else if (arg == "--mode" && i + 1 < argc) {
+            if (!parseSearchMode(argv[++i], mode)) {
+                cerr << "Mode tidak dikenal: " << argv[i]
+                     << " (pilihan: dijkstra, astar, bidirectional, bidirectional-astar, ch)" << endl;
+                return 1;
+            }
+        } else if (arg == "--graph" && i + 1 < argc) {
+            graphFile = argv[++i];
+        } else if (arg == "--updates" && i + 1 < argc) {
+            updatesFile = argv[++i];
+        } else if (arg == "--import" && i + 1 < argc) {
+            importFile = argv[++i];
+        } else if (arg == "--save-graph" && i + 1 < argc) {
+            saveGraphFile = argv[++i];
+        } else if (arg == "--render" && i + 1 < argc) {
+            render.imageFile = argv[++i];
+        } else if (arg == "--tiles" && i + 1 < argc) {
+            render.tilesDir = argv[++i];
+        } else if (arg == "--zoom" && i + 1 < argc) {
+            render.zoom = max(0, min(MapRenderer::MAX_ZOOM, atoi(argv[++i])));
+        } else if (arg == "--center" && i + 1 < argc) {
+            render.hasCenter = sscanf(argv[++i], "%lf,%lf", &render.centerX, &render.centerY) == 2;
+            if (!render.hasCenter) {
+                cerr << "Format --center: x,y" << endl;
+                return 1;
+            }
+        } else if (arg == "--size" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%dx%d", &render.width, &render.height) != 2 || render.width <= 0 ||
+                render.height <= 0 || render.width > 16384 || render.height > 16384) {
+                cerr << "Format --size: LEBARxTINGGI (maksimal 16384)" << endl;
+                return 1;
+            }
+        } else if (arg == "--route" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%d,%d", &render.routeStart, &render.routeEnd) != 2) {
+                cerr << "Format --route: awal,tujuan" << endl;
+                return 1;
+            }
+            render.routeStart--;
+            render.routeEnd--;
+        } else if (arg == "--kernel" && i + 1 < argc) {
+            DistanceKernel kernel;
+            if (!parseDistanceKernel(argv[++i], kernel) || !setDistanceKernel(kernel)) {
+                cerr << "Kernel jarak tidak dikenal atau tidak didukung CPU ini: " << argv[i]
+                     << " (pilihan: scalar, sse2, avx2)" << endl;
+                return 1;
+            }
+        } else if (arg == "--generate-builtin" && i + 1 < argc) {
+            builtinFile = argv[++i];
+        } else if (arg == "--check-builtin") {
+            checkBuiltin = true;
+        } else if (arg == "--verify") {
+            verify = true;
+        } else if (arg == "--tree-cache" && i + 1 < argc) {
+            treeCacheEntries = max(0, atoi(argv[++i]));
+        } else if (arg == "--tree-cache-mb" && i + 1 < argc) {
+            treeCacheMb = max(0.0, atof(argv[++i]));
+        } else if (arg == "--stats") {
+            if (!MAPS_INSTRUMENTATION) {
+                cerr << "--stats butuh build dengan MAPS_INSTRUMENTATION=1" << endl;
+                return 1;
+            }
+            stats = true;
+        } else {
+            cerr << "Argumen tidak dikenal: " << arg << endl;
+            return 1;
+        }
+    }
+    
+    if (!builtinFile.empty() || checkBuiltin) {
+        return runBuiltinGraph(builtinFile, threads);
+    }
+    
+    unique_ptr<RoadNetwork> loaded;
+    if (!graphFile.empty()) {
+        auto file = make_shared<MappedGraphFile>();
+        if (!file->open(graphFile, verify)) {
+            cerr << file->error() << endl;
+            return 1;
+        }
+        loaded.reset(new RoadNetwork(file));
+    } else if (!importFile.empty()) {
+        LocationTable table;
+        ImportStats stats;
+        LocationImporter importer;
+        if (!importer.importCsv(importFile, table, stats, &cerr)) {
+            cerr << importer.error() << endl;
+            return 1;
+        }
+        if (table.size() < 2) {
+            cerr << "File impor harus berisi minimal 2 lokasi: " << importFile << endl;
+            return 1;
+        }
+        auto began = chrono::steady_clock::now();
+        loaded.reset(new RoadNetwork(move(table), threads));
+        cerr << "Graph dibangun dalam " << fixed << setprecision(2)
+             << chrono::duration<double>(chrono::steady_clock::now() - began).count() << " s" << endl;
+        if (loaded->symmetrizeStats.tooLong > 0) {
+            cerr << loaded->symmetrizeStats.tooLong << " koneksi tidak dibuat karena lebih panjang dari "
+                 << MAX_EDGE_UNITS * UNIT_TO_KM << " KM" << endl;
+        }
+    } else {
+        // Peta bawaan sudah dibangun saat kompilasi (builtin_graph.h)
+        loaded.reset(new RoadNetwork(builtinGraph()));
+    }
+    RoadNetwork& network = *loaded;
+    network.searchMode = mode;
+    size_t treeCacheBytes = treeCacheMb >= 0 ? (size_t)(treeCacheMb * (1 << 20)) : PathTreeCache::DEFAULT_BYTES;
+    if (treeCacheEntries >= 0) network.treeCache.setCapacity(treeCacheEntries, treeCacheBytes);
+    if (!updatesFile.empty() && applyGraphUpdates(network, updatesFile) != 0) {
+        return 1;
+    }
+    
+    if (!saveGraphFile.empty()) {
+        // Dengan --mode ch hasil preprocessing ikut disimpan
+        if (!network.prepareSearchMode()) {
+            cerr << network.hierarchy.error() << endl;
+            return 1;
+        }
+        if (!network.saveGraphFile(saveGraphFile)) {
+            cerr << network.saveError() << endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (!render.imageFile.empty() || !render.tilesDir.empty()) {
+        return runRender(network, render);
+    }
+    if (!tourStops.empty()) {
+        tour.threads = threads;
+        return runTour(network, tourStops, tour);
+    }
+    if (!isochroneSources.empty()) {
+        if (withinKm < 0) {
+            cerr << "--isochrone butuh --within <km>" << endl;
+            return 1;
+        }
+        return runIsochrone(network, isochroneSources, withinKm);
+    }
+#if HAS_QUERY_SERVER
+    if (!socketPath.empty()) {
+        QueryServer server(network, threads);
+        if (!server.run(socketPath, cerr)) {
+            cerr << server.lastError() << endl;
+            return 1;
+        }
+        return 0;
+    }
+#endif
+    if (!matrixFile.empty()) {
+        return runDistanceMatrix(network, matrixFile, threads);
+    }
+    if (batch) {
+        if (batchFile.empty()) {
+            return runBatchQueries(network, cin, cout, threads, stats, &cerr);
+        }
+        ifstream in(batchFile);
+        if (!in) {
+            cerr << "File tidak bisa dibuka: " << batchFile << endl;
+            return 1;
+        }
+        return runBatchQueries(network, in, cout, threads, stats, &cerr);
+    }
+    
+    // Menu sering ditanya dari lokasi awal yang sama: simpan pohon beberapa lokasi terakhir
+    if (treeCacheEntries < 0) network.treeCache.setCapacity(8, treeCacheBytes);
+    // Koordinat layar bawaan hanya berlaku selama lokasinya belum diubah --updates
+    bool builtinLayout = graphFile.empty() && importFile.empty() && updatesFile.empty();
+    GoogleMapsSimulator simulator(network, builtinLayout ? &builtinGraph().screen : nullptr);
     simulator.run();
     return 0;
-}
\ No newline at end of file
+}
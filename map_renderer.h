@@ -0,0 +1,588 @@
+#pragma once
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "graph_types.h"
+#include "road_network.h"
+
+// Renderer peta tanpa BGI: merasterisasi ke memori dan menulis file PPM, sehingga peta dan
+// jalur bisa digambar di Linux maupun tanpa layar. Peta dipotong menjadi tile 256x256 per
+// level zoom (seperti peta web); tile dasar disimpan di cache LRU dan dipakai ulang untuk
+// geser/zoom dan overlay jalur. Hanya edge dan lokasi yang mengenai tile yang digambar.
+
+struct Color {
+    uint8_t r, g, b;
+};
+
+// Warna mengikuti palet BGI yang dipakai drawMap
+const Color COLOR_BACKGROUND = {0, 0, 170};   // BLUE
+const Color COLOR_GRID = {85, 85, 85};        // DARKGRAY
+const Color COLOR_ROAD = {170, 170, 170};     // LIGHTGRAY
+const Color COLOR_LOCATION = {170, 0, 0};     // RED
+const Color COLOR_TEXT = {255, 255, 255};     // WHITE
+const Color COLOR_PATH = {255, 255, 85};      // YELLOW
+const Color COLOR_START = {0, 170, 0};        // GREEN
+const Color COLOR_END = {170, 0, 170};        // MAGENTA
+
+// Gambar RGB 8-bit sederhana dengan primitif yang dibutuhkan peta
+class Raster {
+private:
+    // Font bitmap 5x7 untuk ' '..'Z' dan '|', per kolom (bit 0 = baris atas); huruf kecil memakai huruf besar
+    static const uint8_t* glyph(char c) {
+        static const uint8_t FONT[][5] = {
+            {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00},
+            {0x14, 0x7F, 0x14, 0x7F, 0x14}, {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+            {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00}, {0x00, 0x1C, 0x22, 0x41, 0x00},
+            {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+            {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x00, 0x60, 0x60, 0x00},
+            {0x20, 0x10, 0x08, 0x04, 0x02}, {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+            {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33}, {0x18, 0x14, 0x12, 0x7F, 0x10},
+            {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+            {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x00, 0x14, 0x00, 0x00},
+            {0x00, 0x40, 0x34, 0x00, 0x00}, {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+            {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06}, {0x3E, 0x41, 0x5D, 0x59, 0x4E},
+            {0x7C, 0x12, 0x11, 0x12, 0x7C}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+            {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01},
+            {0x3E, 0x41, 0x41, 0x51, 0x73}, {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+            {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41}, {0x7F, 0x40, 0x40, 0x40, 0x40},
+            {0x7F, 0x02, 0x1C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+            {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46},
+            {0x26, 0x49, 0x49, 0x49, 0x32}, {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+            {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F}, {0x63, 0x14, 0x08, 0x14, 0x63},
+            {0x03, 0x04, 0x78, 0x04, 0x03}, {0x61, 0x59, 0x49, 0x4D, 0x43},
+        };
+        static const uint8_t BAR[5] = {0x00, 0x00, 0x7F, 0x00, 0x00};
+        if (c == '|') return BAR;
+        if (c >= 'a' && c <= 'z') c = c - 'a' + 'A';
+        if (c < ' ' || c > 'Z') c = '?';
+        return FONT[c - ' '];
+    }
+    
+    // Potong segmen ke persegi [lo, hi] (Liang-Barsky); false jika seluruhnya di luar
+    static bool clip(double& x1, double& y1, double& x2, double& y2, double lo, double hiX, double hiY) {
+        double t0 = 0, t1 = 1;
+        double dx = x2 - x1, dy = y2 - y1;
+        double p[4] = {-dx, dx, -dy, dy};
+        double q[4] = {x1 - lo, hiX - x1, y1 - lo, hiY - y1};
+        for (int k = 0; k < 4; k++) {
+            if (p[k] == 0) {
+                if (q[k] < 0) return false;
+                continue;
+            }
+            double t = q[k] / p[k];
+            if (p[k] < 0) {
+                t0 = max(t0, t);
+            } else {
+                t1 = min(t1, t);
+            }
+            if (t0 > t1) return false;
+        }
+        double ox = x1, oy = y1;
+        x1 = ox + t0 * dx;
+        y1 = oy + t0 * dy;
+        x2 = ox + t1 * dx;
+        y2 = oy + t1 * dy;
+        return true;
+    }
+    
+public:
+    static constexpr int GLYPH_ADVANCE = 6; // Lebar satu karakter (5 kolom + 1 spasi) pada skala 1
+    
+    int width = 0, height = 0;
+    vector<uint8_t> pixels; // RGB per piksel, baris demi baris
+    
+    Raster() {}
+    Raster(int width, int height, Color background) : width(width), height(height), pixels((size_t)width * height * 3) {
+        fill(background);
+    }
+    
+    void fill(Color color) {
+        for (size_t i = 0; i < pixels.size(); i += 3) {
+            pixels[i] = color.r;
+            pixels[i + 1] = color.g;
+            pixels[i + 2] = color.b;
+        }
+    }
+    
+    void setPixel(int x, int y, Color color) {
+        if (x < 0 || y < 0 || x >= width || y >= height) return;
+        uint8_t* p = &pixels[((size_t)y * width + x) * 3];
+        p[0] = color.r;
+        p[1] = color.g;
+        p[2] = color.b;
+    }
+    
+    void fillRect(int x, int y, int w, int h, Color color) {
+        for (int yy = max(0, y); yy < min(height, y + h); yy++) {
+            for (int xx = max(0, x); xx < min(width, x + w); xx++) {
+                setPixel(xx, yy, color);
+            }
+        }
+    }
+    
+    // Garis (Bresenham) dengan ketebalan; koordinat boleh jauh di luar gambar
+    void line(double x1, double y1, double x2, double y2, Color color, int thickness = 1) {
+        double margin = thickness;
+        if (!clip(x1, y1, x2, y2, -margin, width - 1 + margin, height - 1 + margin)) return;
+        int ax = (int)lround(x1), ay = (int)lround(y1);
+        int bx = (int)lround(x2), by = (int)lround(y2);
+        int dx = abs(bx - ax), sx = ax < bx ? 1 : -1;
+        int dy = -abs(by - ay), sy = ay < by ? 1 : -1;
+        int err = dx + dy;
+        int half = thickness / 2;
+        while (true) {
+            if (thickness == 1) {
+                setPixel(ax, ay, color);
+            } else {
+                fillRect(ax - half, ay - half, thickness, thickness, color);
+            }
+            if (ax == bx && ay == by) break;
+            int e2 = 2 * err;
+            if (e2 >= dy) {
+                err += dy;
+                ax += sx;
+            }
+            if (e2 <= dx) {
+                err += dx;
+                ay += sy;
+            }
+        }
+    }
+    
+    void fillCircle(int cx, int cy, int radius, Color color) {
+        for (int dy = -radius; dy <= radius; dy++) {
+            for (int dx = -radius; dx <= radius; dx++) {
+                if (dx * dx + dy * dy <= radius * radius) setPixel(cx + dx, cy + dy, color);
+            }
+        }
+    }
+    
+    // Teks dengan font 5x7; (x, y) = pojok kiri atas, scale memperbesar setiap piksel font
+    void text(int x, int y, string_view str, Color color, int scale = 1) {
+        for (char c : str) {
+            if (x >= width) break;
+            const uint8_t* columns = glyph(c);
+            for (int col = 0; col < 5; col++) {
+                for (int row = 0; row < 8; row++) {
+                    if (columns[col] & (1 << row)) fillRect(x + col * scale, y + row * scale, scale, scale, color);
+                }
+            }
+            x += GLYPH_ADVANCE * scale;
+        }
+    }
+    
+    // Salin src ke gambar ini dengan pojok kiri atas di (x, y)
+    void blit(const Raster& src, int x, int y) {
+        int fromX = max(0, -x), toX = min(src.width, width - x);
+        if (fromX >= toX) return;
+        for (int row = max(0, -y); row < min(src.height, height - y); row++) {
+            copy_n(&src.pixels[((size_t)row * src.width + fromX) * 3], (toX - fromX) * 3,
+                   &pixels[((size_t)(row + y) * width + x + fromX) * 3]);
+        }
+    }
+    
+    bool writePpm(const string& path) const {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        fprintf(file, "P6\n%d %d\n255\n", width, height);
+        bool ok = fwrite(pixels.data(), 1, pixels.size(), file) == pixels.size();
+        return fclose(file) == 0 && ok;
+    }
+};
+
+// Index spasial edge dan lokasi untuk culling viewport. Batas sel dari kuantil koordinat lokasi
+// (GridAxis, sama seperti SpatialGrid). Setiap edge (sekali per pasangan) hanya masuk ke sel yang
+// benar-benar dilalui garisnya; di dalam sel, edge diurutkan dari yang terpanjang sehingga
+// level-of-detail cukup berhenti begitu edge terlalu pendek untuk terlihat.
+class RenderIndex {
+private:
+    static const int MAX_CELLS = 1 << 22; // Batas jumlah sel (offset sel tetap muat di int)
+    GridAxis columns, rowAxis;
+    int cols = 0, rows = 0;
+    vector<int> edgeCellStart, edgeCellItems;
+    vector<int> nodeCellStart, nodeCellItems;
+    vector<unsigned> edgeStamp; // Mencegah edge yang ada di beberapa sel digambar dua kali
+    unsigned stamp = 0;
+    
+    static int clampCoordinate(double v) {
+        return (int)max((double)INT_MIN, min((double)INT_MAX, floor(v)));
+    }
+    int cellX(double x) const { return columns.cellOf(clampCoordinate(x)); }
+    int cellY(double y) const { return rowAxis.cellOf(clampCoordinate(y)); }
+    
+    // Panggil visit(cell) untuk setiap sel yang dilalui garis (ux, uy) - (vx, vy): mulai dari sel
+    // ujung pertama, lalu pindah ke kolom atau baris berikutnya sesuai batas mana yang dilewati
+    // garis lebih dulu. Jika garis tepat melewati sudut sel, kedua sel di sebelahnya ikut.
+    template <typename Visit>
+    void forEachCrossedCell(int ux, int uy, int vx, int vy, Visit visit) const {
+        int c = cellX(ux), r = cellY(uy);
+        int lastC = cellX(vx), lastR = cellY(vy);
+        int stepC = lastC > c ? 1 : -1, stepR = lastR > r ? 1 : -1;
+        double dx = (double)vx - ux, dy = (double)vy - uy;
+        double inf = numeric_limits<double>::infinity();
+        while (true) {
+            visit(r * cols + c);
+            if (c == lastC && r == lastR) break;
+            double tx = inf, ty = inf;
+            if (c != lastC) tx = ((double)columns.starts[stepC > 0 ? c + 1 : c] - ux) / dx;
+            if (r != lastR) ty = ((double)rowAxis.starts[stepR > 0 ? r + 1 : r] - uy) / dy;
+            if (tx <= ty) {
+                c += stepC;
+            } else {
+                r += stepR;
+            }
+        }
+    }
+    
+public:
+    vector<int32_t> edgeFrom, edgeTo;
+    vector<Weight> edgeWeight; // Bobot graph (untuk label jarak)
+    vector<float> edgeLength;  // Panjang garis dalam satuan koordinat (untuk level-of-detail)
+    
+    void build(const RoadNetwork& network) {
+        const LocationTable& locations = network.locations;
+        const CsrGraph& graph = network.graph;
+        int n = network.numLocations;
+        edgeFrom.clear();
+        edgeTo.clear();
+        edgeWeight.clear();
+        edgeLength.clear();
+        
+        // Sekitar 4 lokasi per sel
+        if (n == 0) {
+            columns = rowAxis = GridAxis();
+            cols = rows = 0;
+        } else {
+            GridAxis::split(locations.xs, locations.ys, n, min(n / 4.0, (double)MAX_CELLS), columns, rowAxis);
+            cols = columns.cells();
+            rows = rowAxis.cells();
+        }
+        int cells = cols * rows;
+        
+        // Pasangan (sel, edge) dikumpulkan sekali selagi koordinat kedua ujung sudah dibaca;
+        // lokasi tetangga tersebar acak di memori, jadi membacanya lagi di setiap pass mahal
+        vector<pair<int, int>> crossings;
+        for (int u = 0; u < n; u++) {
+            int ux = locations.xs[u], uy = locations.ys[u];
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.targets[e];
+                if (u >= v) continue;
+                int vx = locations.xs[v], vy = locations.ys[v];
+                int edge = edgeFrom.size();
+                edgeFrom.push_back(u);
+                edgeTo.push_back(v);
+                edgeWeight.push_back(graph.weights[e]);
+                edgeLength.push_back((float)hypot((double)ux - vx, (double)uy - vy));
+                forEachCrossedCell(ux, uy, vx, vy, [&](int cell) { crossings.push_back({cell, edge}); });
+            }
+        }
+        
+        // Counting sort seperti SpatialGrid: hitung, prefix sum, lalu isi
+        edgeCellStart.assign(cells + 1, 0);
+        for (const auto& crossing : crossings) edgeCellStart[crossing.first + 1]++;
+        for (int c = 0; c < cells; c++) edgeCellStart[c + 1] += edgeCellStart[c];
+        edgeCellItems.assign(crossings.size(), 0);
+        vector<int> fill(edgeCellStart.begin(), edgeCellStart.end() - 1);
+        for (const auto& crossing : crossings) edgeCellItems[fill[crossing.first]++] = crossing.second;
+        for (int c = 0; c < cells; c++) {
+            sort(edgeCellItems.begin() + edgeCellStart[c], edgeCellItems.begin() + edgeCellStart[c + 1],
+                 [&](int a, int b) { return edgeLength[a] > edgeLength[b]; });
+        }
+        
+        nodeCellStart.assign(cells + 1, 0);
+        for (int i = 0; i < n; i++) {
+            if (network.isRemoved(i)) continue;
+            nodeCellStart[cellY(locations.ys[i]) * cols + cellX(locations.xs[i]) + 1]++;
+        }
+        for (int c = 0; c < cells; c++) nodeCellStart[c + 1] += nodeCellStart[c];
+        nodeCellItems.assign(nodeCellStart[cells], 0);
+        fill.assign(nodeCellStart.begin(), nodeCellStart.end() - 1);
+        for (int i = 0; i < n; i++) {
+            if (network.isRemoved(i)) continue;
+            nodeCellItems[fill[cellY(locations.ys[i]) * cols + cellX(locations.xs[i])]++] = i;
+        }
+        
+        edgeStamp.assign(edgeFrom.size(), 0);
+        stamp = 0;
+    }
+    
+    // Panggil visit(k) sekali untuk setiap edge dengan panjang >= minLength yang melewati sel
+    // yang mengenai persegi dunia [x1, x2] x [y1, y2]
+    template <typename Visit>
+    void forEachEdge(double x1, double y1, double x2, double y2, double minLength, Visit visit) {
+        if (cols == 0) return;
+        if (++stamp == 0) {
+            fill(edgeStamp.begin(), edgeStamp.end(), 0);
+            stamp = 1;
+        }
+        for (int r = cellY(y1); r <= cellY(y2); r++) {
+            for (int c = cellX(x1); c <= cellX(x2); c++) {
+                int cell = r * cols + c;
+                for (int k = edgeCellStart[cell]; k < edgeCellStart[cell + 1]; k++) {
+                    int edge = edgeCellItems[k];
+                    if (edgeLength[edge] < minLength) break;
+                    if (edgeStamp[edge] == stamp) continue;
+                    edgeStamp[edge] = stamp;
+                    visit(edge);
+                }
+            }
+        }
+    }
+    
+    template <typename Visit>
+    void forEachNode(double x1, double y1, double x2, double y2, Visit visit) const {
+        if (cols == 0) return;
+        for (int r = cellY(y1); r <= cellY(y2); r++) {
+            for (int c = cellX(x1); c <= cellX(x2); c++) {
+                int cell = r * cols + c;
+                for (int k = nodeCellStart[cell]; k < nodeCellStart[cell + 1]; k++) visit(nodeCellItems[k]);
+            }
+        }
+    }
+};
+
+// Renderer tile dengan cache. Koordinat piksel global pada zoom z: seluruh peta (persegi
+// sisi span) selebar TILE_SIZE * 2^z piksel, sumbu y dibalik seperti toScreenY.
+class MapRenderer {
+public:
+    static constexpr int TILE_SIZE = 256;
+    static constexpr int MAX_ZOOM = 20;
+    
+private:
+    static const int GRID_SPACING = 64;         // Jarak garis grid dalam piksel (selaras tile)
+    static constexpr double MIN_EDGE_PIXELS = 1.5; // Edge lebih pendek dari ini tidak digambar
+    static constexpr double LABEL_SPACING = 60;    // Label muncul jika jarak rata-rata lokasi >= ini (piksel)
+    static constexpr double EDGE_LABEL_PIXELS = 80; // Label jarak hanya untuk edge sepanjang ini
+    static const int MAX_LABEL_CHARS = 32;
+    
+    const RoadNetwork& network;
+    RenderIndex index;
+    unsigned long long indexRevision = ~0ULL;
+    double originX = 0, originTop = 0; // Koordinat dunia piksel (0, 0) pada semua zoom
+    double span = 1;                   // Sisi persegi dunia yang tercakup tile zoom 0
+    double averageSpacing = 1;         // Perkiraan jarak antar lokasi (satuan koordinat)
+    
+    typedef list<pair<uint64_t, shared_ptr<const Raster>>> LruList;
+    LruList lru;
+    unordered_map<uint64_t, LruList::iterator> byKey;
+    size_t maxTiles = 256;
+    long long hitCount = 0, missCount = 0;
+    
+    // Tile di luar peta (indeks negatif atau >= 2^zoom) tetap sah: berisi grid dan ujung label
+    static uint64_t tileKey(int zoom, int tx, int ty) {
+        const uint64_t mask = (1ULL << 29) - 1;
+        return ((uint64_t)zoom << 58) | (((uint64_t)(tx + (1 << 28)) & mask) << 29) | ((uint64_t)(ty + (1 << 28)) & mask);
+    }
+    
+    // Index dan cache dibangun ulang hanya jika graph berubah sejak terakhir digambar
+    void refresh() {
+        if (indexRevision == network.graphRevision()) return;
+        indexRevision = network.graphRevision();
+        index.build(network);
+        clearCache();
+        
+        const LocationTable& locations = network.locations;
+        int minX = 0, maxX = 0, minY = 0, maxY = 0, visible = 0;
+        for (int i = 0; i < network.numLocations; i++) {
+            if (network.isRemoved(i)) continue;
+            if (visible++ == 0) {
+                minX = maxX = locations.xs[i];
+                minY = maxY = locations.ys[i];
+            }
+            minX = min(minX, locations.xs[i]);
+            maxX = max(maxX, locations.xs[i]);
+            minY = min(minY, locations.ys[i]);
+            maxY = max(maxY, locations.ys[i]);
+        }
+        double size = max(1, max(maxX - minX, maxY - minY));
+        double pad = size * 0.05 + 1;
+        span = size + 2 * pad;
+        originX = (minX + maxX) / 2.0 - span / 2;
+        originTop = (minY + maxY) / 2.0 + span / 2;
+        averageSpacing = sqrt(max(1.0, (double)(maxX - minX + 1) * (maxY - minY + 1)) / max(1, visible));
+    }
+    
+    double unitsPerPixel(int zoom) const { return span / TILE_SIZE / (double)(1LL << zoom); }
+    
+    shared_ptr<const Raster> renderTile(int zoom, int tx, int ty) {
+        auto raster = make_shared<Raster>(TILE_SIZE, TILE_SIZE, COLOR_BACKGROUND);
+        double upp = unitsPerPixel(zoom);
+        double left = (double)tx * TILE_SIZE, top = (double)ty * TILE_SIZE;
+        auto pixelX = [&](int worldX) { return (worldX - originX) / upp - left; };
+        auto pixelY = [&](int worldY) { return (originTop - worldY) / upp - top; };
+        
+        // Grid dalam piksel global agar garisnya menyambung antar tile
+        for (int x = 0; x < TILE_SIZE; x += GRID_SPACING) raster->line(x, 0, x, TILE_SIZE - 1, COLOR_GRID);
+        for (int y = 0; y < TILE_SIZE; y += GRID_SPACING) raster->line(0, y, TILE_SIZE - 1, y, COLOR_GRID);
+        
+        // Level-of-detail ditentukan zoom saja (bukan isi tile) agar tile bersebelahan konsisten
+        double spacingPixels = averageSpacing / upp;
+        bool labels = spacingPixels >= LABEL_SPACING;
+        int textScale = spacingPixels >= 2.5 * LABEL_SPACING ? 2 : 1;
+        int radius = spacingPixels >= 12 ? 3 : spacingPixels >= 4 ? 1 : 0;
+        
+        // Persegi dunia tile, diperlebar agar label yang dimulai di tile tetangga tetap terpotong benar
+        double labelWidth = labels ? (MAX_LABEL_CHARS + 4) * Raster::GLYPH_ADVANCE * textScale : 0;
+        double margin = (radius + 1 + (labels ? 10 + 8 * textScale : 0)) * upp;
+        double worldLeft = originX + left * upp, worldRight = originX + (left + TILE_SIZE) * upp;
+        double worldTop = originTop - top * upp, worldBottom = originTop - (top + TILE_SIZE) * upp;
+        
+        const LocationTable& locations = network.locations;
+        vector<int> labelled;
+        index.forEachEdge(worldLeft - margin - labelWidth * upp, worldBottom - margin, worldRight + margin,
+                          worldTop + margin, MIN_EDGE_PIXELS * upp, [&](int k) {
+            int a = index.edgeFrom[k], b = index.edgeTo[k];
+            raster->line(pixelX(locations.xs[a]), pixelY(locations.ys[a]), pixelX(locations.xs[b]),
+                         pixelY(locations.ys[b]), COLOR_ROAD);
+            if (labels && index.edgeLength[k] / upp >= EDGE_LABEL_PIXELS) labelled.push_back(k);
+        });
+        // Label jarak di tengah edge, setelah semua garis agar tidak tertimpa
+        char label[MAX_LABEL_CHARS + 16];
+        for (int k : labelled) {
+            int a = index.edgeFrom[k], b = index.edgeTo[k];
+            snprintf(label, sizeof(label), "%.2f", toUnits(index.edgeWeight[k]) * UNIT_TO_KM);
+            raster->text((int)lround((pixelX(locations.xs[a]) + pixelX(locations.xs[b])) / 2),
+                         (int)lround((pixelY(locations.ys[a]) + pixelY(locations.ys[b])) / 2), label, COLOR_TEXT,
+                         textScale);
+        }
+        
+        index.forEachNode(worldLeft - margin - labelWidth * upp, worldBottom - margin, worldRight + margin,
+                          worldTop + margin, [&](int i) {
+            int x = (int)lround(pixelX(locations.xs[i])), y = (int)lround(pixelY(locations.ys[i]));
+            if (radius > 0) {
+                raster->fillCircle(x, y, radius, COLOR_LOCATION);
+            } else {
+                raster->setPixel(x, y, COLOR_LOCATION);
+            }
+            if (labels) {
+                string_view name = locations[i].name.substr(0, MAX_LABEL_CHARS);
+                snprintf(label, sizeof(label), "%d. %.*s", i + 1, (int)name.size(), name.data());
+                raster->text(x + 10, y - 10, label, COLOR_TEXT, textScale);
+            }
+        });
+        return raster;
+    }
+    
+public:
+    explicit MapRenderer(const RoadNetwork& network) : network(network) {}
+    
+    // Kapasitas cache dalam jumlah tile (masing-masing 192 KB); 0 = cache mati
+    void setCacheCapacity(size_t tiles) {
+        maxTiles = tiles;
+        while (lru.size() > maxTiles) {
+            byKey.erase(lru.back().first);
+            lru.pop_back();
+        }
+    }
+    
+    void clearCache() {
+        lru.clear();
+        byKey.clear();
+    }
+    
+    long long cacheHits() const { return hitCount; }
+    long long cacheMisses() const { return missCount; }
+    size_t cachedTiles() const { return lru.size(); }
+    
+    // Zoom terbesar yang masih memuat seluruh peta dalam width x height piksel
+    int zoomToFit(int width, int height) const {
+        int zoom = 0;
+        while (zoom < MAX_ZOOM && ((long long)TILE_SIZE << (zoom + 1)) <= min(width, height)) zoom++;
+        return zoom;
+    }
+    
+    // Titik tengah peta dalam koordinat dunia
+    pair<double, double> mapCenter() {
+        refresh();
+        return {originX + span / 2, originTop - span / 2};
+    }
+    
+    // Tile dasar (tanpa jalur) dari cache, atau digambar lalu disimpan
+    shared_ptr<const Raster> tile(int zoom, int tx, int ty) {
+        refresh();
+        uint64_t key = tileKey(zoom, tx, ty);
+        auto it = byKey.find(key);
+        if (it != byKey.end()) {
+            hitCount++;
+            lru.splice(lru.begin(), lru, it->second);
+            return it->second->second;
+        }
+        missCount++;
+        shared_ptr<const Raster> raster = renderTile(zoom, tx, ty);
+        if (maxTiles == 0) return raster;
+        if (lru.size() >= maxTiles) {
+            byKey.erase(lru.back().first);
+            lru.pop_back();
+        }
+        lru.push_front({key, raster});
+        byKey[key] = lru.begin();
+        return raster;
+    }
+    
+    // Gambar width x height piksel berpusat di (centerX, centerY) dunia dari tile-tile dasar,
+    // lalu overlay jalur (boleh kosong) dan baris keterangan di pojok kanan bawah
+    Raster renderView(double centerX, double centerY, int zoom, int width, int height,
+                      const vector<int>& path = vector<int>(), const vector<string>& info = vector<string>()) {
+        refresh();
+        zoom = max(0, min(MAX_ZOOM, zoom));
+        double upp = unitsPerPixel(zoom);
+        long long left = llround((centerX - originX) / upp) - width / 2;
+        long long top = llround((originTop - centerY) / upp) - height / 2;
+        
+        Raster view(width, height, COLOR_BACKGROUND);
+        long long firstX = (long long)floor((double)left / TILE_SIZE);
+        long long lastX = (long long)floor((double)(left + width - 1) / TILE_SIZE);
+        long long firstY = (long long)floor((double)top / TILE_SIZE);
+        long long lastY = (long long)floor((double)(top + height - 1) / TILE_SIZE);
+        for (long long ty = firstY; ty <= lastY; ty++) {
+            for (long long tx = firstX; tx <= lastX; tx++) {
+                view.blit(*tile(zoom, (int)tx, (int)ty), (int)(tx * TILE_SIZE - left), (int)(ty * TILE_SIZE - top));
+            }
+        }
+        
+        const LocationTable& locations = network.locations;
+        auto pixelX = [&](int worldX) { return (worldX - originX) / upp - left; };
+        auto pixelY = [&](int worldY) { return (originTop - worldY) / upp - top; };
+        if (path.size() >= 2) {
+            for (size_t i = 0; i + 1 < path.size(); i++) {
+                view.line(pixelX(locations.xs[path[i]]), pixelY(locations.ys[path[i]]),
+                          pixelX(locations.xs[path[i + 1]]), pixelY(locations.ys[path[i + 1]]), COLOR_PATH, 3);
+            }
+            view.fillCircle((int)lround(pixelX(locations.xs[path[0]])), (int)lround(pixelY(locations.ys[path[0]])), 6,
+                            COLOR_START);
+            view.fillCircle((int)lround(pixelX(locations.xs[path.back()])),
+                            (int)lround(pixelY(locations.ys[path.back()])), 6, COLOR_END);
+        }
+        
+        int lineHeight = 20;
+        int infoY = height - (int)info.size() * lineHeight - 30;
+        for (size_t i = 0; i < info.size(); i++) {
+            view.text(width - 500, infoY + (int)i * lineHeight, info[i], COLOR_TEXT, 2);
+        }
+        return view;
+    }
+    
+    // Tulis semua tile zoom z ke dir/z-x-y.ppm (direktori harus sudah ada); nilai balik = jumlah tile
+    int writeTiles(const string& dir, int zoom, string& error) {
+        long long tiles = 1LL << zoom;
+        int written = 0;
+        for (long long ty = 0; ty < tiles; ty++) {
+            for (long long tx = 0; tx < tiles; tx++) {
+                string path = dir + "/" + to_string(zoom) + "-" + to_string(tx) + "-" + to_string(ty) + ".ppm";
+                if (!tile(zoom, (int)tx, (int)ty)->writePpm(path)) {
+                    error = "Gagal menulis " + path;
+                    return written;
+                }
+                written++;
+            }
+        }
+        return written;
+    }
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "graph_types.h"
+
+struct NameMatch {
+    int location;
+    int edits;     // 0 = cocok persis sebagai awalan kata; 1-2 = hasil pencarian fuzzy
+};
+
+// Index nama lokasi untuk autocomplete: array terurut berisi setiap awal kata di nama
+// (sufiks nama mulai dari kata itu), tanpa membedakan huruf besar/kecil. Awalan query
+// cocok dengan rentang yang bersebelahan, jadi pencarian cukup dua binary search langsung
+// di arena nama LocationTable tanpa menyalin string.
+//
+// Fuzzy: jika tidak ada yang cocok, query diperbaiki pada posisi pertama yang gagal
+// (hapus, sisipkan, ganti atau tukar huruf) dengan huruf yang memang muncul di index,
+// sampai MAX_EDITS perubahan.
+//
+// Lokasi yang ditambahkan setelah build disimpan di daftar kecil yang diperiksa linear, lalu
+// digabung ke array terurut begitu jumlahnya melewati PENDING_LIMIT.
+class NameIndex {
+private:
+    static const int MAX_EDITS = 2;
+    static const int PENDING_LIMIT = 4096;
+    static const int CANDIDATE_FACTOR = 4; // Kandidat yang diperingkat = limit x ini
+    static const int NO_MATCH = 4;
+    
+    struct Token {
+        uint32_t offset;  // Posisi awal kata di arena nama
+        int32_t location;
+    };
+    
+    const LocationTable* table = nullptr;
+    vector<Token> tokens;
+    int indexedCount = 0; // Lokasi [0, indexedCount) ada di tokens, sisanya di daftar tertunda
+    
+    static unsigned char fold(char c) {
+        return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : (unsigned char)c;
+    }
+    
+    static bool isWordChar(char c) {
+        return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (unsigned char)c >= 0x80;
+    }
+    
+    const char* nameEnd(const Token& t) const { return table->names + table->nameOffsets[t.location + 1]; }
+    
+    // Bandingkan sufiks t dengan query: 0 jika query awalan sufiks, <0 jika sufiks lebih kecil
+    int comparePrefix(const Token& t, string_view query) const {
+        const char* p = table->names + t.offset;
+        const char* end = nameEnd(t);
+        for (char q : query) {
+            if (p == end) return -1;
+            int diff = (int)fold(*p) - (int)fold(q);
+            if (diff != 0) return diff;
+            p++;
+        }
+        return 0;
+    }
+    
+    // 8 huruf pertama sufiks sebagai bilangan big-endian; sufiks pendek diisi 0 sehingga urutannya
+    // sama dengan lessSuffix (nama yang lebih pendek lebih dulu)
+    uint64_t prefixKey(const Token& t, int skip) const {
+        const char* end = nameEnd(t);
+        const char* p = min(table->names + t.offset + skip, end);
+        uint64_t key = 0;
+        for (int k = 0; k < 8; k++) {
+            key = (key << 8) | (p < end ? fold(*p++) : 0);
+        }
+        return key;
+    }
+    
+    bool lessSuffix(const Token& a, const Token& b) const {
+        const char* p = table->names + a.offset;
+        const char* pe = nameEnd(a);
+        const char* q = table->names + b.offset;
+        const char* qe = nameEnd(b);
+        for (; p < pe && q < qe; p++, q++) {
+            if (fold(*p) != fold(*q)) return fold(*p) < fold(*q);
+        }
+        if ((p == pe) != (q == qe)) return p == pe;
+        return a.location < b.location;
+    }
+    
+    // Rentang token dengan query sebagai awalan, dicari di dalam [lo, hi)
+    pair<int, int> prefixRange(string_view query, int lo, int hi) const {
+        auto first = partition_point(tokens.begin() + lo, tokens.begin() + hi,
+                                     [&](const Token& t) { return comparePrefix(t, query) < 0; });
+        auto last = partition_point(first, tokens.begin() + hi,
+                                    [&](const Token& t) { return comparePrefix(t, query) == 0; });
+        return {(int)(first - tokens.begin()), (int)(last - tokens.begin())};
+    }
+    
+    // Seberapa baik query cocok dengan nama lokasi: 0 = kata pertama persis, 1 = kata lain persis,
+    // 2 = awalan kata pertama, 3 = awalan kata lain, NO_MATCH = tidak cocok
+    int matchRank(int location, string_view query) const {
+        uint32_t begin = table->nameOffsets[location], end = table->nameOffsets[location + 1];
+        int best = NO_MATCH;
+        for (uint32_t p = begin; p < end; p++) {
+            if (!isWordChar(table->names[p]) || (p > begin && isWordChar(table->names[p - 1]))) continue;
+            if (comparePrefix({p, location}, query) != 0) continue;
+            bool wholeWord = p + query.size() == end || !isWordChar(table->names[p + query.size()]);
+            best = min(best, (wholeWord ? 0 : 2) + (p == begin ? 0 : 1));
+        }
+        return best;
+    }
+    
+    template <typename Accept>
+    void addMatch(int location, int edits, Accept& accept, vector<NameMatch>& result) const {
+        if (!accept(location)) return;
+        for (NameMatch& m : result) {
+            if (m.location == location) {
+                m.edits = min(m.edits, edits);
+                return;
+            }
+        }
+        result.push_back({location, edits});
+    }
+    
+    // Kumpulkan lokasi dari rentang awalan (urutan leksikografis) sampai limit lokasi berbeda
+    template <typename Accept>
+    void collect(pair<int, int> range, int edits, int limit, Accept& accept, vector<NameMatch>& result) const {
+        for (int k = range.first; k < range.second && (int)result.size() < limit; k++) {
+            addMatch(tokens[k].location, edits, accept, result);
+        }
+    }
+    
+    // Perbaiki query di posisi pertama yang tidak cocok, maksimal editsLeft kali
+    template <typename Accept>
+    void fuzzy(string query, int editsUsed, int editsLeft, int limit, Accept& accept, vector<NameMatch>& result) const {
+        // Awalan terpanjang yang masih punya pasangan, dipersempit satu huruf setiap langkah
+        pair<int, int> range = {0, (int)tokens.size()};
+        size_t matched = 0;
+        while (matched < query.size()) {
+            pair<int, int> next = prefixRange(string_view(query).substr(0, matched + 1), range.first, range.second);
+            if (next.first == next.second) break;
+            range = next;
+            matched++;
+        }
+        if (matched == query.size()) {
+            collect(range, editsUsed, limit, accept, result);
+            return;
+        }
+        if (editsLeft == 0 || (int)result.size() >= limit) return;
+        
+        string head = query.substr(0, matched);
+        string tail = query.substr(matched + 1);
+        vector<string> variants;
+        variants.push_back(head + tail); // Hapus huruf yang salah
+        if (matched + 1 < query.size()) {
+            variants.push_back(head + query[matched + 1] + query[matched] + query.substr(matched + 2)); // Tukar
+        }
+        // Ganti atau sisipkan: hanya huruf yang benar-benar muncul setelah head di index
+        int k = range.first;
+        while (k < range.second) {
+            const Token& t = tokens[k];
+            const char* p = table->names + t.offset + matched;
+            if (p >= nameEnd(t)) {
+                k++;
+                continue;
+            }
+            char c = (char)fold(*p);
+            variants.push_back(head + c + tail);
+            variants.push_back(head + c + query.substr(matched));
+            k = prefixRange(head + c, k, range.second).second;
+        }
+        for (const string& variant : variants) {
+            if ((int)result.size() >= limit) break;
+            fuzzy(variant, editsUsed + 1, editsLeft - 1, limit, accept, result);
+        }
+    }
+    
+public:
+    // O(T log T) untuk T kata di semua nama; tabel harus tetap hidup selama index dipakai
+    void build(const LocationTable& locations) {
+        table = &locations;
+        tokens.clear();
+        int n = locations.size();
+        for (int i = 0; i < n; i++) {
+            uint32_t begin = locations.nameOffsets[i], end = locations.nameOffsets[i + 1];
+            for (uint32_t p = begin; p < end; p++) {
+                if (isWordChar(locations.names[p]) && (p == begin || !isWordChar(locations.names[p - 1]))) {
+                    tokens.push_back({p, i});
+                }
+            }
+        }
+        
+        // Urutkan dengan kunci 8 huruf pertama (sudah dilipat) agar sebagian besar perbandingan
+        // cukup satu perbandingan integer; sisanya dibandingkan langsung di arena
+        struct Keyed {
+            uint64_t high, low;
+            Token token;
+        };
+        vector<Keyed> keyed(tokens.size());
+        for (size_t k = 0; k < tokens.size(); k++) {
+            keyed[k] = {prefixKey(tokens[k], 0), prefixKey(tokens[k], 8), tokens[k]};
+        }
+        sort(keyed.begin(), keyed.end(), [&](const Keyed& a, const Keyed& b) {
+            if (a.high != b.high) return a.high < b.high;
+            if (a.low != b.low) return a.low < b.low;
+            return lessSuffix(a.token, b.token);
+        });
+        for (size_t k = 0; k < tokens.size(); k++) {
+            tokens[k] = keyed[k].token;
+        }
+        indexedCount = n;
+    }
+    
+    bool isBuilt() const { return table != nullptr; }
+    
+    // Lokasi baru di tabel diperiksa linear sampai jumlahnya cukup banyak untuk build ulang
+    void refresh() {
+        if (table && table->size() - indexedCount > PENDING_LIMIT) build(*table);
+    }
+    
+    // Maksimal limit lokasi yang namanya memuat kata berawalan query (tanpa membedakan huruf
+    // besar/kecil); jika tidak ada, hasil fuzzy dengan edits > 0. accept(i) menyaring lokasi
+    // (misalnya yang sudah dihapus). Urutan: edits kecil dulu, lalu kata yang cocok utuh, lalu
+    // nama yang diawali query, lalu nama yang lebih pendek.
+    template <typename Accept>
+    vector<NameMatch> search(string_view query, int limit, Accept accept) const {
+        vector<NameMatch> result;
+        while (!query.empty() && !isWordChar(query.front())) query.remove_prefix(1);
+        while (!query.empty() && query.back() == ' ') query.remove_suffix(1);
+        if (!table || query.empty() || limit <= 0) return result;
+        
+        // Ambil beberapa kali lipat kandidat (urutan leksikografis) lalu pilih yang terbaik
+        int pool = limit * CANDIDATE_FACTOR;
+        collect(prefixRange(query, 0, tokens.size()), 0, pool, accept, result);
+        for (int i = indexedCount; i < table->size() && (int)result.size() < pool; i++) {
+            if (matchRank(i, query) < NO_MATCH) addMatch(i, 0, accept, result);
+        }
+        for (int edits = 1; edits <= MAX_EDITS && result.empty(); edits++) {
+            if (edits == 2 && query.size() <= 4) break; // Query pendek: dua perubahan terlalu longgar
+            string folded;
+            for (char c : query) folded += (char)fold(c);
+            fuzzy(folded, 0, edits, pool, accept, result);
+        }
+        
+        vector<pair<int, NameMatch>> ranked;
+        for (const NameMatch& m : result) {
+            ranked.push_back({m.edits > 0 ? NO_MATCH : matchRank(m.location, query), m});
+        }
+        stable_sort(ranked.begin(), ranked.end(), [&](const pair<int, NameMatch>& a, const pair<int, NameMatch>& b) {
+            if (a.second.edits != b.second.edits) return a.second.edits < b.second.edits;
+            if (a.first != b.first) return a.first < b.first;
+            return (*table)[a.second.location].name.size() < (*table)[b.second.location].name.size();
+        });
+        result.clear();
+        for (int k = 0; k < (int)ranked.size() && k < limit; k++) {
+            result.push_back(ranked[k].second);
+        }
+        return result;
+    }
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "graph_types.h"
+#include "search_context.h"
+
+// Pohon jalur terpendek lengkap dari satu sumber: jarak dan pendahulu untuk semua simpul
+struct ShortestPathTree {
+    int source = -1;
+    vector<PathLength> dist;
+    vector<int32_t> prev;
+    
+    // Salin hasil Dijkstra penuh (end = -1) dari ctx
+    ShortestPathTree(int source, const SearchContext& ctx, int n) : source(source), dist(n), prev(n) {
+        for (int v = 0; v < n; v++) {
+            dist[v] = ctx.distance(v);
+            prev[v] = ctx.previous(v);
+        }
+    }
+    
+    // Ukuran pohon untuk n simpul (12 byte per simpul)
+    static size_t bytesFor(int n) { return (size_t)n * (sizeof(PathLength) + sizeof(int32_t)); }
+    size_t bytes() const { return bytesFor(dist.size()); }
+    
+    // Jalur ke end dalam O(panjang jalur)
+    RouteResult route(int end) const {
+        RouteResult result;
+        if (dist[end] == UNREACHED) return result;
+        result.distance = toUnits(dist[end]);
+        for (int current = end; current != -1; current = prev[current]) {
+            result.path.push_back(current);
+        }
+        reverse(result.path.begin(), result.path.end());
+        return result;
+    }
+};
+
+// Cache LRU untuk pohon jalur terpendek per lokasi awal, dibatasi jumlah pohon dan total byte.
+// Aman dipakai dari banyak thread; pohon dibagikan lewat shared_ptr sehingga pembaca tidak
+// menahan lock. Pemilik graph wajib memanggil clear() setiap kali graph berubah.
+class PathTreeCache {
+public:
+    static const size_t DEFAULT_BYTES = (size_t)256 << 20;
+    
+private:
+    typedef list<shared_ptr<const ShortestPathTree>> LruList; // Depan = paling baru dipakai
+    
+    mutable mutex lock;
+    LruList lru;
+    unordered_map<int, LruList::iterator> bySource;
+    atomic<size_t> maxEntries{0}, maxBytes{DEFAULT_BYTES};
+    size_t usedBytes = 0;
+    atomic<long long> hitCount{0}, missCount{0};
+    
+    // Buang pohon paling lama sampai extraBytes lagi muat (lock sudah dipegang)
+    void evictFor(size_t extraEntries, size_t extraBytes) {
+        while (!lru.empty() && (lru.size() + extraEntries > maxEntries || usedBytes + extraBytes > maxBytes)) {
+            usedBytes -= lru.back()->bytes();
+            bySource.erase(lru.back()->source);
+            lru.pop_back();
+        }
+    }
+    
+public:
+    // Kapasitas dalam jumlah pohon dan total byte (pohon 12 byte per simpul); 0 pohon = cache mati
+    void setCapacity(size_t entries, size_t bytes = DEFAULT_BYTES) {
+        lock_guard<mutex> guard(lock);
+        maxEntries = entries;
+        maxBytes = bytes;
+        evictFor(0, 0);
+    }
+    
+    size_t capacity() const { return maxEntries.load(memory_order_relaxed); }
+    size_t byteCapacity() const { return maxBytes.load(memory_order_relaxed); }
+    
+    // Cache hanya berguna jika minimal satu pohon untuk n simpul muat; jika tidak, setiap query
+    // akan menjalankan Dijkstra penuh lalu membuang hasilnya
+    bool usable(int n) const { return capacity() > 0 && ShortestPathTree::bytesFor(n) <= byteCapacity(); }
+    
+    size_t size() const {
+        lock_guard<mutex> guard(lock);
+        return lru.size();
+    }
+    
+    size_t bytesUsed() const {
+        lock_guard<mutex> guard(lock);
+        return usedBytes;
+    }
+    
+    // nullptr jika belum ada (dihitung sebagai miss)
+    shared_ptr<const ShortestPathTree> find(int source) {
+        lock_guard<mutex> guard(lock);
+        auto it = bySource.find(source);
+        if (it == bySource.end()) {
+            missCount++;
+            return nullptr;
+        }
+        hitCount++;
+        lru.splice(lru.begin(), lru, it->second);
+        return *it->second;
+    }
+    
+    void insert(shared_ptr<const ShortestPathTree> tree) {
+        lock_guard<mutex> guard(lock);
+        if (maxEntries == 0 || tree->bytes() > maxBytes) return;
+        auto it = bySource.find(tree->source);
+        if (it != bySource.end()) {
+            // Thread lain sudah membangun pohon yang sama; pakai yang lebih baru
+            usedBytes += tree->bytes() - (*it->second)->bytes();
+            *it->second = tree;
+            lru.splice(lru.begin(), lru, it->second);
+            return;
+        }
+        evictFor(1, tree->bytes());
+        usedBytes += tree->bytes();
+        lru.push_front(tree);
+        bySource[tree->source] = lru.begin();
+    }
+    
+    void clear() {
+        lock_guard<mutex> guard(lock);
+        lru.clear();
+        bySource.clear();
+        usedBytes = 0;
+    }
+    
+    long long hits() const { return hitCount.load(); }
+    long long misses() const { return missCount.load(); }
+};
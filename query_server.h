@@ -0,0 +1,549 @@
+#pragma once
+
+// Server query lokal lewat Unix domain socket (khusus Linux): graph dimuat sekali, lalu
+// permintaan dari banyak klien dilayani oleh satu thread event loop (epoll) dan pool worker
+// pencarian.
+//
+// Protokol: satu permintaan per baris, dibalas satu baris JSON dengan urutan yang sama seperti
+// permintaan pada koneksi itu (id = nomor urut permintaan di koneksi, mulai dari 0):
+//   <awal> <tujuan>                rute; ujung seperti --batch (nomor, @x,y atau "nama")
+//   matrix <asal...> ; <tujuan...> matriks jarak dalam KM (null = tidak terhubung)
+//   info                           jumlah lokasi dan mode pencarian
+//   stats                          penghitung server
+//
+// Rute yang masih menunggu di antrian dengan lokasi awal yang sama digabung: satu Dijkstra
+// satu-ke-banyak (routesFrom) menjawab semuanya, jadi lokasi awal yang populer tidak dicari
+// berulang kali. Rute yang tidak tergabung memakai findRoute sesuai searchMode.
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstring>
+#include <list>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "batch_query.h"
+#include "road_network.h"
+
+class QueryServer {
+private:
+    static const int MAX_IN_FLIGHT = 256;          // Permintaan belum dibalas per koneksi sebelum berhenti membaca
+    static const size_t MAX_LINE_BYTES = 65536;
+    static const size_t MAX_MATRIX_CELLS = 1000000;
+    static const size_t READ_CHUNK = 65536;
+    
+    // Kunci epoll untuk fd milik server; koneksi memakai id mulai dari FIRST_CONNECTION
+    static const uint64_t KEY_LISTENER = 0, KEY_WAKE = 1, KEY_SIGNAL = 2, FIRST_CONNECTION = 3;
+    
+    struct Request {
+        uint64_t connection;
+        long long seq;
+        int start = -1, end = -1;
+        vector<int> sources, targets; // Hanya permintaan matrix
+        chrono::steady_clock::time_point received;
+    };
+    
+    // Satu tugas worker: semua rute dengan lokasi awal source, atau satu matrix (source = -1)
+    struct Work {
+        int source;
+        vector<Request> requests;
+    };
+    
+    struct Reply {
+        uint64_t connection;
+        long long seq;
+        string json;
+    };
+    
+    struct Connection {
+        int fd = -1;
+        string input, output;
+        size_t written = 0;
+        long long nextSeq = 0;    // Nomor permintaan berikutnya yang dibaca
+        long long nextReply = 0;  // Nomor balasan berikutnya yang boleh ditulis
+        map<long long, string> replies; // Balasan selesai yang belum gilirannya
+        bool eof = false;
+        uint32_t interest = 0;    // Event epoll yang terdaftar; 0 = fd tidak ada di epoll
+        
+        int inFlight() const { return (int)(nextSeq - nextReply); }
+    };
+    
+    RoadNetwork& network;
+    int workerCount;
+    int epollFd = -1, listenFd = -1, wakeFd = -1, signalFd = -1;
+    unordered_map<uint64_t, Connection> connections;
+    uint64_t nextConnection = FIRST_CONNECTION;
+    string error;
+    
+    // Antrian kerja; pendingBySource menunjuk Work rute yang belum diambil worker
+    mutex workLock;
+    condition_variable workReady;
+    list<Work> workQueue;
+    unordered_map<int, list<Work>::iterator> pendingBySource;
+    bool stopping = false;
+    
+    // Balasan dari worker ke event loop, dibangunkan lewat eventfd
+    mutex replyLock;
+    vector<Reply> finished;
+    
+    atomic<long long> requestCount{0}, searchCount{0}, coalescedCount{0}, errorCount{0};
+    
+    bool fail(const string& message) {
+        error = message + ": " + strerror(errno);
+        return false;
+    }
+    
+    void watch(int fd, uint64_t key, uint32_t events) {
+        epoll_event event = {};
+        event.events = events;
+        event.data.u64 = key;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+    
+    // ---- Worker ----
+    
+    void submit(Work work) {
+        lock_guard<mutex> guard(workLock);
+        if (work.source >= 0) {
+            auto it = pendingBySource.find(work.source);
+            if (it != pendingBySource.end()) {
+                it->second->requests.push_back(move(work.requests[0]));
+                coalescedCount++;
+                return;
+            }
+        }
+        workQueue.push_back(move(work));
+        if (workQueue.back().source >= 0) pendingBySource[workQueue.back().source] = prev(workQueue.end());
+        workReady.notify_one();
+    }
+    
+    void deliver(vector<Reply>& replies) {
+        {
+            lock_guard<mutex> guard(replyLock);
+            for (Reply& reply : replies) finished.push_back(move(reply));
+        }
+        replies.clear();
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeFd, &one, sizeof(one));
+        (void)ignored;
+    }
+    
+    static double microsSince(chrono::steady_clock::time_point began) {
+        return chrono::duration<double, micro>(chrono::steady_clock::now() - began).count();
+    }
+    
+    void workerLoop() {
+        SearchContext ctx;
+        vector<char> isTarget(network.numLocations, 0);
+        vector<Reply> replies;
+        while (true) {
+            Work work;
+            {
+                unique_lock<mutex> guard(workLock);
+                workReady.wait(guard, [&] { return stopping || !workQueue.empty(); });
+                if (stopping) return;
+                work = move(workQueue.front());
+                if (work.source >= 0) pendingBySource.erase(work.source);
+                workQueue.pop_front();
+            }
+            if (work.source < 0) {
+                for (Request& request : work.requests) {
+                    searchCount += request.sources.size();
+                    replies.push_back({request.connection, request.seq, matrixJson(request, ctx, isTarget)});
+                }
+            } else {
+                searchCount++;
+                solveRoutes(work, ctx, replies);
+            }
+            deliver(replies);
+        }
+    }
+    
+    void solveRoutes(Work& work, SearchContext& ctx, vector<Reply>& replies) {
+        vector<RouteResult> routes;
+        if (work.requests.size() == 1) {
+            routes.push_back(network.findRoute(work.source, work.requests[0].end));
+        } else {
+            vector<int> targets;
+            for (const Request& request : work.requests) targets.push_back(request.end);
+            routes = network.routesFrom(work.source, targets, ctx);
+        }
+        char number[96];
+        for (size_t k = 0; k < work.requests.size(); k++) {
+            const Request& request = work.requests[k];
+            string json = "{\"id\":" + to_string(request.seq);
+            appendRouteJson(json, request.start, request.end, routes[k]);
+            snprintf(number, sizeof(number), ",\"settled\":%d,\"coalesced\":%d,\"latency_us\":%.1f}",
+                     routes[k].settledNodes, (int)work.requests.size(), microsSince(request.received));
+            json += number;
+            replies.push_back({request.connection, request.seq, move(json)});
+        }
+    }
+    
+    // Satu oneToMany per asal dengan ruang kerja worker; isTarget dikosongkan lagi setelahnya
+    string matrixJson(const Request& request, SearchContext& ctx, vector<char>& isTarget) {
+        unordered_map<int, int> targetsPerComponent;
+        for (int t : request.targets) {
+            if (!isTarget[t]) targetsPerComponent[network.components.componentOf(t)]++;
+            isTarget[t] = 1;
+        }
+        vector<double> row(request.targets.size());
+        string json = "{\"id\":" + to_string(request.seq) + ",\"distance_km\":[";
+        char number[32];
+        for (size_t i = 0; i < request.sources.size(); i++) {
+            auto it = targetsPerComponent.find(network.components.componentOf(request.sources[i]));
+            int reachableTargets = it != targetsPerComponent.end() ? it->second : 0;
+            network.oneToMany(request.sources[i], request.targets, isTarget, reachableTargets, ctx, row.data());
+            json += i > 0 ? ",[" : "[";
+            for (size_t j = 0; j < row.size(); j++) {
+                if (j > 0) json += ',';
+                if (isinf(row[j])) {
+                    json += "null";
+                } else {
+                    snprintf(number, sizeof(number), "%.3f", row[j] * UNIT_TO_KM);
+                    json += number;
+                }
+            }
+            json += ']';
+        }
+        for (int t : request.targets) isTarget[t] = 0;
+        snprintf(number, sizeof(number), "],\"latency_us\":%.1f}", microsSince(request.received));
+        return json + number;
+    }
+    
+    // ---- Event loop ----
+    
+    void replyError(Connection& c, long long seq, const string& message) {
+        errorCount++;
+        c.replies[seq] = "{\"id\":" + to_string(seq) + ",\"error\":\"" + message + "\"}";
+    }
+    
+    string statsJson() {
+        size_t queued;
+        {
+            lock_guard<mutex> guard(workLock);
+            queued = workQueue.size();
+        }
+        return "{\"requests\":" + to_string(requestCount.load()) + ",\"searches\":" + to_string(searchCount.load()) +
+               ",\"coalesced\":" + to_string(coalescedCount.load()) + ",\"errors\":" + to_string(errorCount.load()) +
+               ",\"connections\":" + to_string(connections.size()) + ",\"queued\":" + to_string(queued) +
+               ",\"workers\":" + to_string(workerCount) + "}";
+    }
+    
+    // Daftar ujung dipisah spasi sampai ";" atau akhir baris
+    bool parseEndpointList(const string& line, size_t& pos, vector<int>& list, string& message) {
+        string token;
+        while (nextEndpoint(line, pos, token)) {
+            if (token == ";") return true;
+            int location = resolveEndpoint(network, token, message);
+            if (location < 0) return false;
+            list.push_back(location);
+        }
+        return true;
+    }
+    
+    void handleLine(uint64_t id, Connection& c, const string& line) {
+        long long seq = c.nextSeq++;
+        requestCount++;
+        Request request;
+        request.connection = id;
+        request.seq = seq;
+        request.received = chrono::steady_clock::now();
+        
+        size_t pos = 0;
+        string first, second, message;
+        if (!nextEndpoint(line, pos, first)) {
+            replyError(c, seq, "baris tidak valid");
+        } else if (first == "info") {
+            c.replies[seq] = "{\"id\":" + to_string(seq) + ",\"locations\":" + to_string(network.numLocations) +
+                             ",\"mode\":\"" + searchModeKey(network.searchMode) + "\"}";
+        } else if (first == "stats") {
+            c.replies[seq] = "{\"id\":" + to_string(seq) + ",\"stats\":" + statsJson() + "}";
+        } else if (first == "matrix") {
+            if (!parseEndpointList(line, pos, request.sources, message) ||
+                !parseEndpointList(line, pos, request.targets, message)) {
+                replyError(c, seq, message);
+            } else if (request.sources.empty() || request.targets.empty()) {
+                replyError(c, seq, "format: matrix <asal...> ; <tujuan...>");
+            } else if (request.sources.size() * request.targets.size() > MAX_MATRIX_CELLS) {
+                replyError(c, seq, "matriks terlalu besar");
+            } else {
+                submit({-1, {move(request)}});
+            }
+        } else if (!nextEndpoint(line, pos, second)) {
+            replyError(c, seq, "baris tidak valid");
+        } else {
+            request.start = resolveEndpoint(network, first, message);
+            if (request.start >= 0) request.end = resolveEndpoint(network, second, message);
+            if (request.start < 0 || request.end < 0) {
+                replyError(c, seq, message);
+            } else {
+                int source = request.start;
+                submit({source, {move(request)}});
+            }
+        }
+    }
+    
+    // Proses baris lengkap di buffer input selama batas permintaan per koneksi belum tercapai
+    void parseLines(uint64_t id, Connection& c) {
+        size_t begin = 0;
+        while (c.inFlight() < MAX_IN_FLIGHT) {
+            size_t newline = c.input.find('\n', begin);
+            if (newline == string::npos) {
+                // Sisa tanpa newline di akhir stream tetap dihitung sebagai satu baris
+                if (c.eof && begin < c.input.size()) {
+                    handleLine(id, c, c.input.substr(begin));
+                    begin = c.input.size();
+                }
+                break;
+            }
+            size_t end = newline;
+            if (end > begin && c.input[end - 1] == '\r') end--;
+            if (c.input.find_first_not_of(" \t", begin) < end) handleLine(id, c, c.input.substr(begin, end - begin));
+            begin = newline + 1;
+        }
+        c.input.erase(0, begin);
+    }
+    
+    // Tulis balasan yang sudah gilirannya, atur minat epoll, tutup jika klien selesai.
+    // false jika koneksi ditutup (c tidak boleh dipakai lagi).
+    bool service(uint64_t id, Connection& c) {
+        parseLines(id, c);
+        if (c.input.size() > MAX_LINE_BYTES && c.input.find('\n') == string::npos) {
+            closeConnection(id);
+            return false;
+        }
+        while (!c.replies.empty() && c.replies.begin()->first == c.nextReply) {
+            c.output += c.replies.begin()->second;
+            c.output += '\n';
+            c.replies.erase(c.replies.begin());
+            c.nextReply++;
+        }
+        while (c.written < c.output.size()) {
+            ssize_t sent = send(c.fd, c.output.data() + c.written, c.output.size() - c.written, MSG_NOSIGNAL);
+            if (sent > 0) {
+                c.written += sent;
+            } else if (sent < 0 && errno == EINTR) {
+                continue;
+            } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            } else {
+                closeConnection(id);
+                return false;
+            }
+        }
+        if (c.written == c.output.size()) {
+            c.output.clear();
+            c.written = 0;
+        }
+        if (c.eof && c.inFlight() == 0 && c.input.empty() && c.output.empty()) {
+            closeConnection(id);
+            return false;
+        }
+        
+        uint32_t interest = (!c.eof && c.inFlight() < MAX_IN_FLIGHT ? (uint32_t)EPOLLIN : 0u) |
+                            (c.output.empty() ? 0u : (uint32_t)EPOLLOUT);
+        if (interest != c.interest) {
+            // Tanpa minat fd dikeluarkan dari epoll: EPOLLHUP/EPOLLERR selalu dilaporkan, jadi klien
+            // yang menutup koneksi saat permintaannya masih diproses akan membuat loop berputar terus.
+            // fd didaftarkan lagi begitu ada balasan yang perlu ditulis.
+            if (interest == 0) {
+                epoll_ctl(epollFd, EPOLL_CTL_DEL, c.fd, nullptr);
+            } else {
+                epoll_event event = {};
+                event.events = interest;
+                event.data.u64 = id;
+                epoll_ctl(epollFd, c.interest == 0 ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, c.fd, &event);
+            }
+            c.interest = interest;
+        }
+        return true;
+    }
+    
+    void closeConnection(uint64_t id) {
+        auto it = connections.find(id);
+        if (it == connections.end()) return;
+        if (it->second.interest != 0) epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second.fd, nullptr);
+        close(it->second.fd);
+        connections.erase(it);
+    }
+    
+    void acceptAll() {
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return; // EAGAIN: tidak ada lagi; error lain dicoba pada event berikutnya
+            uint64_t id = nextConnection++;
+            Connection& c = connections[id];
+            c.fd = fd;
+            c.interest = EPOLLIN;
+            watch(fd, id, EPOLLIN);
+        }
+    }
+    
+    void readFrom(uint64_t id, Connection& c) {
+        char buffer[READ_CHUNK];
+        ssize_t got = recv(c.fd, buffer, sizeof(buffer), 0);
+        if (got > 0) {
+            c.input.append(buffer, got);
+        } else if (got == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            c.eof = true;
+        }
+        service(id, c);
+    }
+    
+    void collectReplies() {
+        uint64_t count;
+        ssize_t ignored = read(wakeFd, &count, sizeof(count));
+        (void)ignored;
+        vector<Reply> replies;
+        {
+            lock_guard<mutex> guard(replyLock);
+            replies.swap(finished);
+        }
+        vector<uint64_t> touched;
+        for (Reply& reply : replies) {
+            auto it = connections.find(reply.connection);
+            if (it == connections.end()) continue; // Klien sudah pergi
+            it->second.replies[reply.seq] = move(reply.json);
+            touched.push_back(reply.connection);
+        }
+        sort(touched.begin(), touched.end());
+        touched.erase(unique(touched.begin(), touched.end()), touched.end());
+        for (uint64_t id : touched) {
+            auto it = connections.find(id);
+            if (it != connections.end()) service(id, it->second);
+        }
+    }
+    
+    bool openSockets(const string& path) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            error = "Path socket kosong atau terlalu panjang: " + path;
+            return false;
+        }
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        
+        // Socket sisa server sebelumnya boleh diganti, file lain tidak
+        struct stat info;
+        if (lstat(path.c_str(), &info) == 0) {
+            if (!S_ISSOCK(info.st_mode)) {
+                error = "Path sudah dipakai dan bukan socket: " + path;
+                return false;
+            }
+            unlink(path.c_str());
+        }
+        listenFd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) return fail("socket");
+        if (bind(listenFd, (sockaddr*)&address, sizeof(address)) < 0) return fail("bind " + path);
+        if (listen(listenFd, SOMAXCONN) < 0) return fail("listen");
+        
+        // SIGINT/SIGTERM dibaca lewat signalfd agar event loop berhenti dengan rapi; mask
+        // dipasang sebelum worker dibuat sehingga diwarisi semua thread
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        signalFd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        if (signalFd < 0 || wakeFd < 0 || epollFd < 0) return fail("epoll");
+        watch(listenFd, KEY_LISTENER, EPOLLIN);
+        watch(wakeFd, KEY_WAKE, EPOLLIN);
+        watch(signalFd, KEY_SIGNAL, EPOLLIN);
+        return true;
+    }
+    
+    void closeSockets(const string& path) {
+        for (auto& entry : connections) close(entry.second.fd);
+        connections.clear();
+        for (int fd : {listenFd, wakeFd, signalFd, epollFd}) {
+            if (fd >= 0) close(fd);
+        }
+        listenFd = wakeFd = signalFd = epollFd = -1;
+        unlink(path.c_str());
+    }
+    
+public:
+    // threads = jumlah worker pencarian; 0 berarti semua core
+    QueryServer(RoadNetwork& network, int threads = 0) : network(network) {
+        workerCount = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+    }
+    
+    const string& lastError() const { return error; }
+    
+    // Layani permintaan di socket path sampai SIGINT/SIGTERM; false jika socket gagal dibuka
+    bool run(const string& path, ostream& log) {
+        // Preprocessing (CH, index lokasi dan nama) selesai sebelum worker mulai
+        if (!network.prepareSearchMode()) log << network.hierarchy.error() << ", memakai Dijkstra" << endl;
+        network.prepareLookup();
+        if (!openSockets(path)) {
+            closeSockets(path);
+            return false;
+        }
+        
+        vector<thread> workers;
+        for (int w = 0; w < workerCount; w++) {
+            workers.emplace_back([this] { workerLoop(); });
+        }
+        log << "Server siap di " << path << " (" << workerCount << " worker, mode "
+            << searchModeKey(network.searchMode) << ")" << endl;
+            
+        const int MAX_EVENTS = 64;
+        epoll_event events[MAX_EVENTS];
+        bool running = true;
+        while (running) {
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+            if (count < 0 && errno == EINTR) continue;
+            if (count < 0) {
+                fail("epoll_wait");
+                break;
+            }
+            for (int k = 0; k < count; k++) {
+                uint64_t key = events[k].data.u64;
+                if (key == KEY_LISTENER) {
+                    acceptAll();
+                } else if (key == KEY_WAKE) {
+                    collectReplies();
+                } else if (key == KEY_SIGNAL) {
+                    running = false;
+                } else {
+                    auto it = connections.find(key);
+                    if (it == connections.end()) continue;
+                    if (events[k].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                        readFrom(key, it->second);
+                    } else {
+                        service(key, it->second);
+                    }
+                }
+            }
+        }
+        
+        {
+            lock_guard<mutex> guard(workLock);
+            stopping = true;
+            workReady.notify_all();
+        }
+        for (thread& t : workers) {
+            t.join();
+        }
+        log << "Server berhenti: " << statsJson() << endl;
+        closeSockets(path);
+        return error.empty();
+    }
+};
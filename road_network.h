@@ -0,0 +1,1067 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <map>
+#include <memory>
+#include <set>
+#include <unordered_map>
+
+#include "component_index.h"
+#include "contraction_hierarchy.h"
+#include "distance_kernels.h"
+#include "embedded_graph.h"
+#include "graph_file.h"
+#include "graph_types.h"
+#include "name_index.h"
+#include "path_tree_cache.h"
+#include "search_context.h"
+#include "search_stats.h"
+#include "spatial_grid.h"
+#include "work_stealing_pool.h"
+
+// Jaringan jalan beserta semua algoritma pencariannya, tanpa ketergantungan ke tampilan
+// (BGI/konsol), sehingga bisa dipakai oleh menu interaktif maupun mode batch.
+class RoadNetwork {
+private:
+    static constexpr int MAX_CONNECTIONS = 5;      // Maksimal 5 koneksi per lokasi
+    static constexpr double MAX_DISTANCE = 2000;   // Maksimal jarak koneksi langsung
+    static constexpr int BUILD_CHUNK = 4096;       // Lokasi per tugas paralel di buildGraph
+    
+    shared_ptr<const MappedGraphFile> mappedFile; // Pemilik halaman mmap jika graph dibaca dari file
+    
+    // Susun jalur start -> end dari array prev hasil pencarian
+    vector<int> tracePath(const SearchContext& ctx, int end) {
+        vector<int> path;
+        for (int current = end; current != -1; current = ctx.previous(current)) {
+            path.push_back(current);
+        }
+        reverse(path.begin(), path.end());
+        return path;
+    }
+    
+    void initialize(int buildThreads) {
+        numLocations = locations.size();
+        
+        // Membuat graph dengan menghubungkan setiap lokasi ke lokasi terdekat
+        buildGraph(buildThreads);
+    }
+    
+    // Query lewat cache pohon jalur terpendek: lokasi awal yang sering dipakai cukup dihitung
+    // sekali dengan Dijkstra penuh, query berikutnya hanya menelusuri prev dari end
+    RouteResult routeFromTreeCache(int start, int end, SearchContext& ctx) {
+        RouteResult result;
+        shared_ptr<const ShortestPathTree> tree = treeCache.find(start);
+        if (!tree) {
+            RouteResult full = dijkstra(start, -1, ctx);
+            tree = make_shared<ShortestPathTree>(start, ctx, numLocations);
+            treeCache.insert(tree);
+            result.settledNodes = full.settledNodes;
+            result.counters = full.counters;
+        }
+        RouteResult found = tree->route(end);
+        result.distance = found.distance;
+        result.path = move(found.path);
+        return result;
+    }
+    
+    // Tetangga pilihan lokasi i sendiri (sebelum dibuat dua arah): cukup ambil MAX_CONNECTIONS
+    // titik terdekat dalam MAX_DISTANCE, minimal 2 titik terdekat untuk koneksi cadangan kecuali
+    // yang lebih jauh dari MAX_EDGE_UNITS (bobotnya tidak muat; dihitung di tooLong jika ada).
+    // Hasilnya adalah awalan candidates (terurut jarak) sepanjang nilai balik.
+    int selectNeighbors(const SpatialGrid& grid, int i, vector<pair<double, int>>& candidates,
+                        int* tooLong = nullptr) const {
+        grid.kNearest(locations[i].x, locations[i].y, MAX_CONNECTIONS, i, MAX_DISTANCE, 2, candidates);
+        
+        // Ambil maksimal MAX_CONNECTIONS titik terdekat, jangan terlalu jauh
+        int connectionCount = 0;
+        for (auto& dist : candidates) {
+            if (connectionCount >= MAX_CONNECTIONS) break;
+            if (dist.first > MAX_DISTANCE) break;
+            connectionCount++;
+        }
+        
+        // Pastikan setiap lokasi minimal terhubung ke 2 titik terdekat
+        if (connectionCount < 2 && candidates.size() >= 2) connectionCount = 2;
+        while (connectionCount > 0 && candidates[connectionCount - 1].first > MAX_EDGE_UNITS) {
+            connectionCount--;
+            if (tooLong) (*tooLong)++;
+        }
+        return connectionCount;
+    }
+    
+    // Jalankan job(begin, end, worker) untuk setiap potongan [0, count) sebesar BUILD_CHUNK.
+    // Setiap potongan hanya menulis bagiannya sendiri, jadi hasilnya tidak bergantung pada
+    // jumlah thread maupun urutan potongan dikerjakan.
+    static void forChunks(WorkStealingPool& pool, int count, const function<void(int, int, int)>& job) {
+        int chunks = (count + BUILD_CHUNK - 1) / BUILD_CHUNK;
+        pool.run(chunks, [&](int chunk, int worker) {
+            int begin = chunk * BUILD_CHUNK;
+            job(begin, min(count, begin + BUILD_CHUNK), worker);
+        });
+    }
+    
+    // Tetangga pilihan tiap lokasi dalam slot tetap berukuran MAX_CONNECTIONS (kNearest tidak
+    // pernah memberi lebih dari itu), tanpa vector per lokasi selama konstruksi
+    struct ChosenNeighbors {
+        vector<int32_t> targets;
+        vector<Weight> weights;
+        vector<uint8_t> count;
+        
+        void reset(int n) {
+            targets.assign((size_t)n * MAX_CONNECTIONS, 0);
+            weights.assign((size_t)n * MAX_CONNECTIONS, 0);
+            count.assign(n, 0);
+        }
+        
+        const int32_t* row(int i) const { return targets.data() + (size_t)i * MAX_CONNECTIONS; }
+        const Weight* rowWeights(int i) const { return weights.data() + (size_t)i * MAX_CONNECTIONS; }
+        
+        bool contains(int from, int to) const {
+            const int32_t* first = row(from);
+            return find(first, first + count[from], to) != first + count[from];
+        }
+    };
+    
+    void buildGraph(int threads) {
+        // Membuat graph realistis - hanya menghubungkan dengan titik terdekat
+        // Tidak menggunakan complete graph, tapi berdasarkan jarak terdekat
+        
+        auto began = chrono::steady_clock::now();
+        auto lap = [&began] {
+            auto now = chrono::steady_clock::now();
+            double seconds = chrono::duration<double>(now - began).count();
+            began = now;
+            return seconds;
+        };
+        WorkStealingPool pool(threads);
+        buildTimings.threads = pool.workers();
+        
+        ChosenNeighbors chosen;
+        selectAllNeighbors(pool, chosen);
+        
+        // Komponen terhubung ikut dihitung di sini: edge balik dari ensureBidirectionalConnections
+        // tidak mengubah keterhubungan, jadi union per edge pilihan sudah cukup
+        components.reset(numLocations);
+        for (int i = 0; i < numLocations; i++) {
+            const int32_t* targets = chosen.row(i);
+            for (int k = 0; k < chosen.count[i]; k++) {
+                components.unite(i, targets[k]);
+            }
+        }
+        components.flatten();
+        buildTimings.neighbors = lap();
+        
+        // Tambahkan koneksi bidirectional untuk memastikan graf terhubung
+        vector<atomic<int32_t>> reverseCount(numLocations);
+        ensureBidirectionalConnections(pool, chosen, reverseCount);
+        buildTimings.symmetrize = lap();
+        
+        // Padatkan ke CSR sekali saja; slot tetangga pilihan tidak dibutuhkan lagi
+        assembleGraph(pool, chosen, reverseCount);
+        buildTimings.compact = lap();
+        graphChanged();
+    }
+    
+    void selectAllNeighbors(WorkStealingPool& pool, ChosenNeighbors& chosen) {
+        // Index spasial agar pencarian tetangga tidak perlu membandingkan semua pasangan
+        SpatialGrid grid;
+        grid.build(locations);
+        chosen.reset(numLocations);
+        symmetrizeStats = SymmetrizeStats();
+        
+        // Lokasi diproses per sel grid, bukan per indeks: lokasi berurutan saling berdekatan
+        // sehingga sel dan koordinat yang dibaca kNearest masih ada di cache. Setiap lokasi
+        // hanya menulis slotnya sendiri; buffer kandidat milik worker.
+        const vector<int>& order = grid.cellOrder();
+        vector<vector<pair<double, int>>> buffers(pool.workers());
+        vector<int> duplicates(pool.workers(), 0), tooLong(pool.workers(), 0);
+        forChunks(pool, numLocations, [&](int begin, int end, int worker) {
+            vector<pair<double, int>>& distances = buffers[worker];
+            for (int k = begin; k < end; k++) {
+                int i = order[k];
+                int count = selectNeighbors(grid, i, distances, &tooLong[worker]);
+                int32_t* targets = chosen.targets.data() + (size_t)i * MAX_CONNECTIONS;
+                Weight* weights = chosen.weights.data() + (size_t)i * MAX_CONNECTIONS;
+                int kept = 0;
+                for (int c = 0; c < count; c++) {
+                    // Buang edge ganda (A -> B lebih dari sekali)
+                    if (find(targets, targets + kept, distances[c].second) != targets + kept) {
+                        duplicates[worker]++;
+                        continue;
+                    }
+                    targets[kept] = distances[c].second;
+                    weights[kept] = toWeight(distances[c].first);
+                    kept++;
+                }
+                chosen.count[i] = kept;
+            }
+        });
+        for (int d : duplicates) symmetrizeStats.duplicates += d;
+        for (int t : tooLong) symmetrizeStats.tooLong += t;
+    }
+    
+    void ensureBidirectionalConnections(WorkStealingPool& pool, const ChosenNeighbors& chosen,
+                                        vector<atomic<int32_t>>& reverseCount) {
+        // Pastikan jika A terhubung ke B, maka B juga terhubung ke A: edge pilihan i -> j tanpa
+        // pasangan j -> i mendapat edge balik di baris j. Cukup periksa slot pilihan j, lalu
+        // hitung jumlah edge balik per baris untuk assembleGraph.
+        vector<int> added(pool.workers(), 0);
+        forChunks(pool, numLocations, [&](int begin, int end, int worker) {
+            for (int i = begin; i < end; i++) {
+                const int32_t* targets = chosen.row(i);
+                for (int k = 0; k < chosen.count[i]; k++) {
+                    int j = targets[k];
+                    if (chosen.contains(j, i)) continue;
+                    reverseCount[j].fetch_add(1, memory_order_relaxed);
+                    added[worker]++;
+                }
+            }
+        });
+        symmetrizeStats.added = 0;
+        for (int a : added) symmetrizeStats.added += a;
+    }
+    
+    // Susun CSR: baris u = tetangga pilihan u (urut jarak), lalu edge balik urut indeks asal,
+    // sama persis dengan hasil versi satu thread
+    void assembleGraph(WorkStealingPool& pool, ChosenNeighbors& chosen, vector<atomic<int32_t>>& reverseCount) {
+        int n = numLocations;
+        auto degree = [&](int u) { return chosen.count[u] + reverseCount[u].load(memory_order_relaxed); };
+        
+        // Prefix sum per potongan: jumlah tiap potongan paralel, offset awal potongan berurutan
+        vector<int32_t> offsets(n + 1, 0);
+        int chunks = (n + BUILD_CHUNK - 1) / BUILD_CHUNK;
+        vector<int32_t> chunkStart(chunks + 1, 0);
+        forChunks(pool, n, [&](int begin, int end, int) {
+            int32_t total = 0;
+            for (int u = begin; u < end; u++) total += degree(u);
+            chunkStart[begin / BUILD_CHUNK + 1] = total;
+        });
+        for (int c = 0; c < chunks; c++) chunkStart[c + 1] += chunkStart[c];
+        forChunks(pool, n, [&](int begin, int end, int) {
+            int32_t offset = chunkStart[begin / BUILD_CHUNK];
+            for (int u = begin; u < end; u++) {
+                offsets[u] = offset;
+                offset += degree(u);
+            }
+        });
+        offsets[n] = chunkStart[chunks];
+        
+        vector<int32_t> targets(offsets[n]);
+        vector<Weight> weights(offsets[n]);
+        forChunks(pool, n, [&](int begin, int end, int) {
+            for (int u = begin; u < end; u++) {
+                copy(chosen.row(u), chosen.row(u) + chosen.count[u], targets.begin() + offsets[u]);
+                copy(chosen.rowWeights(u), chosen.rowWeights(u) + chosen.count[u], weights.begin() + offsets[u]);
+            }
+        });
+        
+        // Edge balik j -> i (bobotnya sama dengan i -> j) diisi dari belakang slotnya dengan urutan
+        // sembarang antar thread, lalu setiap baris diurutkan berdasarkan indeks asal
+        forChunks(pool, n, [&](int begin, int end, int) {
+            for (int i = begin; i < end; i++) {
+                const int32_t* row = chosen.row(i);
+                for (int k = 0; k < chosen.count[i]; k++) {
+                    int j = row[k];
+                    if (chosen.contains(j, i)) continue;
+                    int e = offsets[j] + chosen.count[j] + reverseCount[j].fetch_sub(1, memory_order_relaxed) - 1;
+                    targets[e] = i;
+                    weights[e] = chosen.rowWeights(i)[k];
+                }
+            }
+        });
+        vector<vector<pair<int32_t, Weight>>> buffers(pool.workers());
+        forChunks(pool, n, [&](int begin, int end, int worker) {
+            vector<pair<int32_t, Weight>>& reverse = buffers[worker];
+            for (int u = begin; u < end; u++) {
+                int first = offsets[u] + chosen.count[u], last = offsets[u + 1];
+                if (last - first < 2) continue;
+                reverse.clear();
+                for (int e = first; e < last; e++) reverse.push_back({targets[e], weights[e]});
+                sort(reverse.begin(), reverse.end());
+                for (int e = first; e < last; e++) {
+                    targets[e] = reverse[e - first].first;
+                    weights[e] = reverse[e - first].second;
+                }
+            }
+        });
+        
+        chosen = ChosenNeighbors();
+        graph.adopt(move(offsets), move(targets), move(weights));
+    }
+    
+    // Semua hasil turunan graph (cache pohon jalur terpendek, CH) tidak berlaku lagi
+    void graphChanged() {
+        treeCache.clear();
+        if (hierarchy.isBuilt()) hierarchy.reset();
+        revision++;
+    }
+    
+    unsigned long long revision = 0;
+    
+    // Index pencarian lokasi dari koordinat dan nama; dibangun saat pertama kali dibutuhkan.
+    // locationGrid juga dipakai pembaruan inkremental sehingga selalu berisi lokasi yang aktif.
+    SpatialGrid locationGrid;
+    bool locationGridReady = false;
+    NameIndex nameIndex;
+    
+    void prepareLocationGrid() {
+        if (locationGridReady) return;
+        locationGrid.build(locations);
+        locationGridReady = true;
+    }
+    
+    // Struktur untuk pembaruan inkremental, disiapkan pada pembaruan pertama. Graph akhir selalu
+    // sama dengan: edge (u, v) ada jika v ada di nearest[u] atau u ada di nearest[v], kecuali
+    // ditutup, dengan bobot jarak garis lurus atau bobot yang diubah.
+    bool updatesReady = false;
+    vector<vector<int>> nearest;             // Tetangga pilihan tiap lokasi sendiri (selectNeighbors)
+    vector<char> removed;
+    RadiusIndex sparseNodes;                 // Lokasi dengan insertThreshold > MAX_DISTANCE, radius = ambangnya
+    set<pair<int, int>> closedEdges;         // Disimpan dua arah: (a, b) dan (b, a)
+    map<pair<int, int>, double> weightOverrides; // Kunci (kecil, besar)
+    vector<Edge> rowScratch;
+    string updateErrorMessage;
+    string saveErrorMessage;
+    
+    static pair<int, int> edgeKey(int a, int b) { return {min(a, b), max(a, b)}; }
+    
+    static bool contains(const vector<int>& list, int v) {
+        return find(list.begin(), list.end(), v) != list.end();
+    }
+    
+    // O(n) sekali: daftar tetangga semua lokasi, grid yang bisa diubah, dan graph editable
+    void enableUpdates() {
+        if (!graph.isEditable()) graph.makeEditable();
+        if (updatesReady) return;
+        locations.makeOwned();
+        prepareLocationGrid();
+        removed.assign(numLocations, 0);
+        nearest.assign(numLocations, vector<int>());
+        vector<pair<double, int>> candidates;
+        for (int i = 0; i < numLocations; i++) {
+            int count = selectNeighbors(locationGrid, i, candidates);
+            for (int k = 0; k < count; k++) {
+                nearest[i].push_back(candidates[k].second);
+            }
+            updateSparse(i);
+        }
+        updatesReady = true;
+    }
+    
+    // Lokasi baru p masuk ke daftar tetangga u hanya jika jaraknya ke u tidak lebih dari ambang ini.
+    // Dengan kurang dari 2 tetangga, p selalu termasuk 2 terdekat tapi tetap dibuang jika lebih
+    // jauh dari MAX_EDGE_UNITS.
+    double insertThreshold(int u) const {
+        const vector<int>& list = nearest[u];
+        if (list.size() < 2) return MAX_EDGE_UNITS;
+        double last = calculateDistance(locations[u], locations[list.back()]);
+        if ((int)list.size() == MAX_CONNECTIONS || last > MAX_DISTANCE) return last;
+        return MAX_DISTANCE;
+    }
+    
+    void updateSparse(int u) {
+        double threshold = insertThreshold(u);
+        if (!removed[u] && threshold > MAX_DISTANCE) {
+            sparseNodes.insert(u, locations[u].x, locations[u].y, threshold);
+        } else {
+            sparseNodes.erase(u, locations[u].x, locations[u].y);
+        }
+    }
+    
+    // Hitung ulang daftar tetangga u lalu perbaiki edge yang masuk atau keluar dari daftar
+    void refreshNeighbors(int u, vector<pair<double, int>>& candidates) {
+        vector<int> fresh;
+        if (!removed[u]) {
+            int count = selectNeighbors(locationGrid, u, candidates);
+            for (int k = 0; k < count; k++) {
+                fresh.push_back(candidates[k].second);
+            }
+        }
+        vector<int> old = move(nearest[u]);
+        nearest[u] = fresh;
+        updateSparse(u);
+        for (int v : old) {
+            if (!contains(fresh, v)) refreshEdge(u, v);
+        }
+        for (int v : fresh) {
+            if (!contains(old, v)) refreshEdge(u, v);
+        }
+    }
+    
+    // Samakan kedua arc a <-> b dengan aturan graph di atas
+    void refreshEdge(int a, int b) {
+        pair<int, int> key = edgeKey(a, b);
+        bool justified = !removed[a] && !removed[b] && (contains(nearest[a], b) || contains(nearest[b], a));
+        if (!justified) {
+            closedEdges.erase({a, b});
+            closedEdges.erase({b, a});
+            weightOverrides.erase(key);
+        }
+        bool open = justified && !closedEdges.count({a, b});
+        auto it = weightOverrides.find(key);
+        Weight weight = toWeight(it != weightOverrides.end() ? it->second : calculateDistance(locations[a], locations[b]));
+        setArc(a, b, open, weight);
+        setArc(b, a, open, weight);
+    }
+    
+    void setArc(int u, int v, bool present, Weight weight) {
+        rowScratch.clear();
+        bool found = false;
+        for (int e = graph.begin(u); e < graph.end(u); e++) {
+            if (graph.targets[e] == v) {
+                found = true;
+                if (present) rowScratch.push_back(Edge(v, weight));
+            } else {
+                rowScratch.push_back(Edge(graph.targets[e], graph.weights[e]));
+            }
+        }
+        if (!found && !present) return;
+        if (!found) {
+            rowScratch.push_back(Edge(v, weight));
+            components.unite(u, v);
+        } else if (!present) {
+            components.markInexact(); // Komponen mungkin terpecah; lihat refreshComponents()
+        }
+        graph.setRow(u, rowScratch);
+    }
+    
+    bool hasArc(int u, int v) const {
+        for (int e = graph.begin(u); e < graph.end(u); e++) {
+            if (graph.targets[e] == v) return true;
+        }
+        return false;
+    }
+    
+    bool validPair(int a, int b) {
+        if (a < 0 || a >= numLocations || b < 0 || b >= numLocations || a == b) {
+            updateErrorMessage = "Nomor lokasi tidak valid";
+            return false;
+        }
+        return true;
+    }
+    
+public:
+    LocationTable locations;
+    CsrGraph graph;                 // Graph final (immutable) yang dipakai pencarian dan tampilan
+    int numLocations = 0;
+    SymmetrizeStats symmetrizeStats;
+    BuildTimings buildTimings;
+    SearchMode searchMode = MODE_DIJKSTRA;
+    ContractionHierarchy hierarchy; // Dibangun saat mode CH pertama kali dipakai
+    SessionStats sessionStats;      // Statistik semua query findRoute (lihat search_stats.h)
+    PathTreeCache treeCache;        // Pohon jalur terpendek per lokasi awal; kapasitas 0 = mati
+    ComponentIndex components;      // Komponen terhubung, untuk menolak query yang mustahil
+    
+    // buildThreads: jumlah thread untuk buildGraph (0 = semua core); hasilnya identik untuk
+    // berapa pun jumlah threadnya
+    explicit RoadNetwork(const vector<Point>& points, int buildThreads = 0) {
+        size_t nameBytes = 0;
+        for (const Point& p : points) nameBytes += p.name.size();
+        locations.reserve(points.size(), nameBytes);
+        for (const Point& p : points) {
+            locations.add(p.x, p.y, p.name);
+        }
+        initialize(buildThreads);
+    }
+    
+    // Lokasi yang sudah tersusun (misalnya hasil LocationImporter) dipindahkan tanpa disalin
+    explicit RoadNetwork(LocationTable&& table, int buildThreads = 0) : locations(move(table)) {
+        initialize(buildThreads);
+    }
+    
+    // Graph dari file biner yang sudah di-mmap: lokasi, CSR dan (jika ada) CH langsung memakai
+    // halaman file, tanpa buildGraph dan tanpa menyalin data
+    explicit RoadNetwork(shared_ptr<const MappedGraphFile> file) : mappedFile(file) {
+        const GraphFileHeader& h = file->header();
+        numLocations = h.nodeCount;
+        locations.attach(numLocations, file->section<int32_t>(SECTION_X), file->section<int32_t>(SECTION_Y),
+                         file->section<uint32_t>(SECTION_NAME_OFFSETS), file->section<char>(SECTION_NAME_CHARS));
+        graph.attach(numLocations, file->section<int32_t>(SECTION_CSR_OFFSETS),
+                     file->section<int32_t>(SECTION_CSR_TARGETS), file->section<Weight>(SECTION_CSR_WEIGHTS));
+        if (file->hasHierarchy()) {
+            hierarchy.attach(numLocations, h.shortcutCount,
+                             {file->section<int32_t>(SECTION_CH_UP_OFFSETS), file->section<int32_t>(SECTION_CH_UP_TARGETS),
+                              file->section<Weight>(SECTION_CH_UP_WEIGHTS), file->section<int32_t>(SECTION_CH_UP_MIDDLE),
+                              file->section<int32_t>(SECTION_CH_UP_FIRST_HALF), file->section<int32_t>(SECTION_CH_UP_SECOND_HALF)},
+                             {file->section<int32_t>(SECTION_CH_DOWN_OFFSETS), file->section<int32_t>(SECTION_CH_DOWN_TARGETS),
+                              file->section<Weight>(SECTION_CH_DOWN_WEIGHTS), file->section<int32_t>(SECTION_CH_DOWN_MIDDLE),
+                              file->section<int32_t>(SECTION_CH_DOWN_FIRST_HALF), file->section<int32_t>(SECTION_CH_DOWN_SECOND_HALF)});
+        }
+        components.build(graph);
+    }
+    
+    // Graph yang sudah dihitung saat kompilasi (builtin_graph.h): tabel statis dipakai langsung
+    // seperti file graph, tanpa buildGraph dan tanpa menyalin data
+    explicit RoadNetwork(const EmbeddedGraph& embedded) {
+        numLocations = embedded.nodeCount;
+        locations.attach(numLocations, embedded.xs, embedded.ys, embedded.nameOffsets, embedded.names);
+        graph.attach(numLocations, embedded.offsets, embedded.targets, embedded.weights);
+        components.load(numLocations, embedded.componentRoots, embedded.componentSizes);
+        symmetrizeStats.added = embedded.reverseArcs;
+        symmetrizeStats.duplicates = embedded.duplicateArcs;
+    }
+    
+    // Simpan lokasi, CSR dan hasil CH (jika sudah dibangun) ke file graph biner. File graph tidak
+    // menyimpan tanda lokasi dihapus, jadi graph yang punya lokasi terhapus ditolak (lihat saveError()).
+    bool saveGraphFile(const string& path) {
+        if (count(removed.begin(), removed.end(), 1) > 0) {
+            saveErrorMessage = "Graph berisi lokasi yang sudah dihapus; file graph tidak bisa menyimpannya";
+            return false;
+        }
+        saveErrorMessage = "Gagal menulis file graph: " + path;
+        graph.compact(); // Graph yang pernah diubah disimpan kembali dalam bentuk padat
+        GraphFileWriter writer;
+        uint32_t flags = hierarchy.isBuilt() ? GRAPH_FILE_HAS_HIERARCHY : 0;
+        if (!writer.open(path, numLocations, graph.numEdges(), flags, hierarchy.shortcuts())) return false;
+        
+        int n = numLocations;
+        writer.addSection(locations.xs, n * sizeof(int32_t));
+        writer.addSection(locations.ys, n * sizeof(int32_t));
+        writer.addSection(locations.nameOffsets, (n + 1) * sizeof(uint32_t));
+        writer.addSection(locations.names, locations.nameBytes());
+        writer.addSection(graph.offsets, (n + 1) * sizeof(int32_t));
+        writer.addSection(graph.targets, graph.numEdges() * sizeof(int32_t));
+        writer.addSection(graph.weights, graph.numEdges() * sizeof(Weight));
+        
+        ContractionHierarchy::UpwardArrays parts[2] = {hierarchy.forwardArrays(), hierarchy.backwardArrays()};
+        for (const auto& part : parts) {
+            size_t m = flags ? part.offsets[n] : 0;
+            writer.addSection(part.offsets, flags ? (n + 1) * sizeof(int32_t) : 0);
+            writer.addSection(part.targets, m * sizeof(int32_t));
+            writer.addSection(part.weights, m * sizeof(Weight));
+            writer.addSection(part.middle, m * sizeof(int32_t));
+            writer.addSection(part.firstHalf, m * sizeof(int32_t));
+            writer.addSection(part.secondHalf, m * sizeof(int32_t));
+        }
+        return writer.finish();
+    }
+    
+    // ===== Pembaruan inkremental =====
+    // Setiap perubahan hanya menghitung ulang daftar tetangga lokasi di sekitarnya beserta
+    // edge baliknya, lalu membuang hasil turunan (cache pohon jalur terpendek, CH). Pembaruan
+    // pertama menyiapkan strukturnya sekali (O(n)). Jangan dijalankan bersamaan dengan query.
+    // Jika gagal, nilai balik false/-1 dan alasannya ada di updateError().
+    
+    // Tambah lokasi baru; nilai balik = indeks lokasi tersebut
+    int addLocation(int x, int y, string_view name) {
+        enableUpdates();
+        int p = numLocations;
+        locations.add(x, y, name);
+        graph.addNode();
+        components.addNode();
+        removed.push_back(0);
+        nearest.emplace_back();
+        numLocations++;
+        locationGrid.insert(p);
+        
+        // Yang mungkin memilih p: lokasi dalam MAX_DISTANCE dan lokasi jarang yang ambangnya
+        // mencapai p (hanya yang di sekitar p yang diperiksa)
+        vector<pair<double, int>> candidates;
+        locationGrid.kNearest(x, y, INT_MAX, p, MAX_DISTANCE, 0, candidates);
+        vector<int> affected;
+        sparseNodes.query(x, y, affected);
+        for (const auto& c : candidates) {
+            if (c.first > MAX_DISTANCE) break;
+            affected.push_back(c.second);
+        }
+        sort(affected.begin(), affected.end());
+        affected.erase(unique(affected.begin(), affected.end()), affected.end());
+        
+        refreshNeighbors(p, candidates);
+        for (int u : affected) {
+            if (u != p && calculateDistance(locations[u], locations[p]) <= insertThreshold(u)) {
+                refreshNeighbors(u, candidates);
+            }
+        }
+        graphChanged();
+        return p;
+    }
+    
+    // Hapus lokasi: indeksnya tetap terpakai (lokasi lain tidak bergeser) tetapi tanpa edge
+    bool removeLocation(int p) {
+        if (p < 0 || p >= numLocations) {
+            updateErrorMessage = "Nomor lokasi tidak valid";
+            return false;
+        }
+        enableUpdates();
+        if (removed[p]) {
+            updateErrorMessage = "Lokasi sudah dihapus";
+            return false;
+        }
+        
+        // Lokasi yang memilih p pasti bertetangga dengan p, lewat edge terbuka atau yang ditutup
+        vector<int> affected;
+        for (int e = graph.begin(p); e < graph.end(p); e++) {
+            affected.push_back(graph.targets[e]);
+        }
+        for (auto it = closedEdges.lower_bound({p, INT_MIN}); it != closedEdges.end() && it->first == p; ++it) {
+            affected.push_back(it->second);
+        }
+        
+        removed[p] = 1;
+        locationGrid.remove(p);
+        vector<pair<double, int>> candidates;
+        refreshNeighbors(p, candidates);
+        for (int u : affected) {
+            refreshNeighbors(u, candidates);
+        }
+        graphChanged();
+        return true;
+    }
+    
+    // Tutup jalan a <-> b (kedua arah); bobotnya diingat untuk reopenEdge
+    bool closeEdge(int a, int b) {
+        if (!validPair(a, b)) return false;
+        enableUpdates();
+        if (!hasArc(a, b)) {
+            updateErrorMessage = "Tidak ada jalan terbuka antara kedua lokasi";
+            return false;
+        }
+        closedEdges.insert({a, b});
+        closedEdges.insert({b, a});
+        refreshEdge(a, b);
+        graphChanged();
+        return true;
+    }
+    
+    bool reopenEdge(int a, int b) {
+        if (!validPair(a, b)) return false;
+        enableUpdates();
+        if (!closedEdges.count({a, b})) {
+            updateErrorMessage = "Jalan antara kedua lokasi tidak sedang ditutup";
+            return false;
+        }
+        closedEdges.erase({a, b});
+        closedEdges.erase({b, a});
+        refreshEdge(a, b);
+        graphChanged();
+        return true;
+    }
+    
+    // Ubah bobot jalan a <-> b (satuan koordinat, misalnya karena macet). Bobot tidak boleh di
+    // bawah jarak garis lurus agar heuristik A* dan potensial dua arah tetap valid.
+    bool reweightEdge(int a, int b, double weight) {
+        if (!validPair(a, b)) return false;
+        enableUpdates();
+        if (!hasArc(a, b) && !closedEdges.count({a, b})) {
+            updateErrorMessage = "Tidak ada jalan antara kedua lokasi";
+            return false;
+        }
+        if (weight < calculateDistance(locations[a], locations[b])) {
+            updateErrorMessage = "Bobot tidak boleh lebih kecil dari jarak garis lurus";
+            return false;
+        }
+        if (weight > MAX_EDGE_UNITS) {
+            updateErrorMessage = "Bobot melebihi batas panjang edge";
+            return false;
+        }
+        weightOverrides[edgeKey(a, b)] = weight;
+        refreshEdge(a, b);
+        graphChanged();
+        return true;
+    }
+    
+    bool isRemoved(int i) const { return i < (int)removed.size() && removed[i]; }
+    bool isClosed(int a, int b) const { return closedEdges.count({a, b}) > 0; }
+    const string& updateError() const { return updateErrorMessage; }
+    const string& saveError() const { return saveErrorMessage; }
+    
+    // Bertambah setiap kali graph atau lokasi berubah; dipakai cache di luar kelas ini (peta)
+    unsigned long long graphRevision() const { return revision; }
+    
+    // Setelah jalan ditutup atau lokasi dihapus, komponen bisa terpecah tanpa terlihat oleh
+    // union-find. Penolakan query tetap benar, tetapi ukuran komponen baru tepat setelah ini (O(n + m)).
+    void refreshComponents() {
+        if (!components.isExact()) components.build(graph);
+    }
+    
+    // Bangun index lookup (grid lokasi dan index nama) jika belum ada. Panggil sebelum
+    // nearestLocation / findLocationsByName dipakai dari lebih dari satu thread.
+    void prepareLookup() {
+        prepareLocationGrid();
+        if (!nameIndex.isBuilt()) {
+            nameIndex.build(locations);
+        } else {
+            nameIndex.refresh();
+        }
+    }
+    
+    // Lokasi aktif terdekat dari titik (x, y) sembarang; -1 jika tidak ada lokasi sama sekali
+    int nearestLocation(int x, int y, double* distance = nullptr) {
+        prepareLookup();
+        static thread_local vector<pair<double, int>> candidates;
+        locationGrid.kNearest(x, y, 1, -1, 0, 1, candidates);
+        if (candidates.empty()) return -1;
+        if (distance) *distance = candidates[0].first;
+        return candidates[0].second;
+    }
+    
+    // Lokasi aktif yang namanya memuat kata berawalan query (lihat NameIndex::search)
+    vector<NameMatch> findLocationsByName(string_view query, int limit) {
+        prepareLookup();
+        return nameIndex.search(query, limit, [this](int i) { return !isRemoved(i); });
+    }
+    
+    // Menghitung jarak Euclidean antara dua titik
+    double calculateDistance(const LocationView& a, const LocationView& b) const {
+        return pointDistance(a.x, a.y, b.x, b.y);
+    }
+    
+    // Dijkstra dengan ruang kerja yang dipakai ulang. end = -1 berarti bangun seluruh pohon
+    // jalur terpendek; setelah itu ctx.distance(v) / ctx.previous(v) bisa dibaca untuk semua v
+    // sampai query berikutnya memakai ctx yang sama.
+    RouteResult dijkstra(int start, int end, SearchContext& ctx) {
+        ctx.prepare(numLocations);
+        ctx.reach(start, 0, -1);
+        int settledNodes = 0;
+        
+        while (!ctx.heapEmpty()) {
+            int u = ctx.popMin();
+            
+            if (ctx.settled(u)) continue;
+            ctx.settle(u);
+            settledNodes++;
+            
+            if (u == end) break;
+            
+            PathLength du = ctx.distance(u);
+            ctx.scanned(graph.degree(u));
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.targets[e];
+                PathLength nd = du + graph.weights[e];
+                
+                if (!ctx.settled(v) && nd < ctx.distance(v)) {
+                    ctx.reach(v, nd, u);
+                }
+            }
+        }
+        
+        RouteResult result;
+        result.settledNodes = settledNodes;
+        result.counters = ctx.counters;
+        if (end >= 0 && ctx.reached(end)) {
+            result.distance = toUnits(ctx.distance(end));
+            result.path = tracePath(ctx, end);
+        }
+        return result;
+    }
+    
+    // A*: sama seperti Dijkstra, tetapi prioritas heap ditambah jarak garis lurus ke tujuan.
+    // Bobot edge adalah jarak Euclidean, jadi heuristik ini admissible dan konsisten (lihat
+    // HEURISTIC_SCALE untuk pengaruh pembulatan).
+    RouteResult aStar(int start, int end, SearchContext& ctx) {
+        ctx.prepare(numLocations);
+        int endX = locations.xs[end], endY = locations.ys[end];
+        ctx.reach(start, 0, -1, toHeuristic(calculateDistance(locations[start], locations[end])));
+        int settledNodes = 0;
+        
+        while (!ctx.heapEmpty()) {
+            int u = ctx.popMin();
+            
+            if (ctx.settled(u)) continue;
+            ctx.settle(u);
+            settledNodes++;
+            
+            if (u == end) break;
+            
+            PathLength du = ctx.distance(u);
+            int first = graph.begin(u), degree = graph.degree(u);
+            ctx.scanned(degree);
+            // Heuristik semua tetangga dihitung sekaligus dengan kernel jarak (distance_kernels.h)
+            double* heuristic = ctx.scratchBuffer(degree);
+            distancesFrom(endX, endY, locations.xs, locations.ys, graph.targets + first, degree, heuristic);
+            for (int k = 0; k < degree; k++) {
+                int v = graph.targets[first + k];
+                PathLength nd = du + graph.weights[first + k];
+                
+                if (!ctx.settled(v) && nd < ctx.distance(v)) {
+                    ctx.reach(v, nd, u, nd + toHeuristic(heuristic[k]));
+                }
+            }
+        }
+        
+        RouteResult result;
+        result.settledNodes = settledNodes;
+        result.counters = ctx.counters;
+        if (ctx.reached(end)) {
+            result.distance = toUnits(ctx.distance(end));
+            result.path = tracePath(ctx, end);
+        }
+        return result;
+    }
+    
+    // Pencarian dua arah: maju dari start dan mundur dari end sampai kedua frontier bertemu.
+    // Pencarian mundur memakai edge yang sama karena ensureBidirectionalConnections menjamin
+    // setiap edge punya edge balik dengan bobot sama. Dengan goalDirected, kedua arah memakai
+    // potensial rata-rata p(v) = (h_end(v) - h_start(v)) / 2 (maju) dan -p(v) (mundur).
+    // Agar tetap integer, semua key dikali dua: key = 2d + (h_end - h_start) untuk arah maju dan
+    // 2d - (h_end - h_start) untuk arah mundur; keduanya tidak pernah negatif karena d >= h.
+    RouteResult bidirectionalSearch(int start, int end, bool goalDirected,
+                                    SearchContext& forward, SearchContext& backward) {
+        auto potential = [&](int v) -> int64_t {
+            if (!goalDirected) return 0;
+            return (int64_t)toHeuristic(calculateDistance(locations[v], locations[end])) -
+                   (int64_t)toHeuristic(calculateDistance(locations[v], locations[start]));
+        };
+        
+        forward.prepare(numLocations);
+        backward.prepare(numLocations);
+        forward.reach(start, 0, -1, potential(start));
+        backward.reach(end, 0, -1, -potential(end));
+        
+        PathLength best = UNREACHED;
+        int meeting = -1;
+        int settledNodes = 0;
+        
+        while (!forward.heapEmpty() && !backward.heapEmpty()) {
+            // Tidak ada jalur lebih pendek yang tersisa jika jumlah key minimum >= jarak terbaik
+            if (forward.minKey() + backward.minKey() >= 2 * best) break;
+            
+            bool isForward = forward.minKey() <= backward.minKey();
+            SearchContext& self = isForward ? forward : backward;
+            SearchContext& other = isForward ? backward : forward;
+            int64_t sign = isForward ? 1 : -1;
+            
+            int u = self.popMin();
+            if (self.settled(u)) continue;
+            self.settle(u);
+            settledNodes++;
+            
+            PathLength du = self.distance(u);
+            int first = graph.begin(u), degree = graph.degree(u);
+            self.scanned(degree);
+            // Potensial semua tetangga dihitung sekaligus: jarak ke end lalu jarak ke start
+            double* toEnd = self.scratchBuffer(2 * degree);
+            double* toStart = toEnd + degree;
+            if (goalDirected) {
+                distancesFrom(locations.xs[end], locations.ys[end], locations.xs, locations.ys,
+                              graph.targets + first, degree, toEnd);
+                distancesFrom(locations.xs[start], locations.ys[start], locations.xs, locations.ys,
+                              graph.targets + first, degree, toStart);
+            }
+            for (int k = 0; k < degree; k++) {
+                int v = graph.targets[first + k];
+                PathLength nd = du + graph.weights[first + k];
+                
+                if (!self.settled(v) && nd < self.distance(v)) {
+                    int64_t p = goalDirected ? (int64_t)toHeuristic(toEnd[k]) - (int64_t)toHeuristic(toStart[k]) : 0;
+                    self.reach(v, nd, u, 2 * nd + sign * p);
+                }
+                if (other.reached(v) && nd + other.distance(v) < best) {
+                    best = nd + other.distance(v);
+                    meeting = v;
+                }
+            }
+        }
+        
+        RouteResult result;
+        result.settledNodes = settledNodes;
+        result.counters = forward.counters;
+        result.counters += backward.counters;
+        if (meeting == -1) return result;
+        
+        // Gabungkan jalur start -> meeting dan meeting -> end
+        result.distance = toUnits(best);
+        result.path = tracePath(forward, meeting);
+        for (int current = backward.previous(meeting); current != -1; current = backward.previous(current)) {
+            result.path.push_back(current);
+        }
+        return result;
+    }
+    
+    // Preprocessing yang dibutuhkan searchMode; panggil sebelum query dari banyak thread.
+    // Jika CH gagal dibangun (hierarchy.error()), searchMode kembali ke Dijkstra dan hasilnya false.
+    bool prepareSearchMode() {
+        if (searchMode == MODE_CONTRACTION_HIERARCHIES && !hierarchy.isBuilt() && !hierarchy.build(graph)) {
+            searchMode = MODE_DIJKSTRA;
+            return false;
+        }
+        return true;
+    }
+    
+    // Jalankan query titik ke titik dengan algoritma sesuai searchMode
+    RouteResult findRoute(int start, int end) {
+        static thread_local SearchContext forward, backward;
+        SEARCH_STAT(auto began = chrono::steady_clock::now());
+        RouteResult result;
+        if (isRemoved(start) || isRemoved(end)) {
+            // Lokasi yang dihapus tidak punya jalan, tetapi union-find masih menaruhnya di komponen
+            // lamanya; tanpa penolakan ini pencarian akan menjelajahi seluruh komponen itu
+        } else if (start == end) {
+            result.distance = 0;
+            result.path.push_back(start);
+        } else if (!components.connected(start, end)) {
+            // Beda komponen: tidak ada jalur, tidak perlu menjelajahi seluruh komponen start
+        } else if (searchMode == MODE_DIJKSTRA && treeCache.usable(numLocations)) {
+            result = routeFromTreeCache(start, end, forward);
+        } else {
+            switch (searchMode) {
+                case MODE_ASTAR:
+                    result = aStar(start, end, forward);
+                    break;
+                case MODE_BIDIRECTIONAL:
+                    result = bidirectionalSearch(start, end, false, forward, backward);
+                    break;
+                case MODE_BIDIRECTIONAL_ASTAR:
+                    result = bidirectionalSearch(start, end, true, forward, backward);
+                    break;
+                case MODE_CONTRACTION_HIERARCHIES:
+                    result = prepareSearchMode() ? hierarchy.query(start, end, forward, backward)
+                                                 : dijkstra(start, end, forward);
+                    break;
+                default:
+                    result = dijkstra(start, end, forward);
+                    break;
+            }
+        }
+        SEARCH_STAT(result.micros = chrono::duration<double, micro>(chrono::steady_clock::now() - began).count());
+        SEARCH_STAT(sessionStats.record(searchMode, result));
+        return result;
+    }
+    
+    // Versi praktis: memakai ruang kerja milik thread pemanggil
+    RouteResult dijkstra(int start, int end) {
+        static thread_local SearchContext ctx;
+        return dijkstra(start, end, ctx);
+    }
+    
+    // Dijkstra satu ke banyak: berhenti segera setelah semua simpul bertanda isTarget diproses.
+    // reachableTargets = jumlah target berbeda di komponen source; target di komponen lain tidak
+    // akan pernah diproses, jadi tidak boleh ikut ditunggu.
+    // Jarak ke targets[j] ditulis ke row[j] (tak hingga jika tidak terhubung).
+    void oneToMany(int source, const vector<int>& targets, const vector<char>& isTarget,
+                   int reachableTargets, SearchContext& ctx, double* row) {
+        ctx.prepare(numLocations);
+        ctx.reach(source, 0, -1);
+        int remaining = reachableTargets;
+        
+        while (!ctx.heapEmpty() && remaining > 0) {
+            int u = ctx.popMin();
+            if (ctx.settled(u)) continue;
+            ctx.settle(u);
+            if (isTarget[u]) remaining--;
+            
+            PathLength du = ctx.distance(u);
+            ctx.scanned(graph.degree(u));
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.targets[e];
+                PathLength nd = du + graph.weights[e];
+                if (!ctx.settled(v) && nd < ctx.distance(v)) {
+                    ctx.reach(v, nd, u);
+                }
+            }
+        }
+        
+        for (size_t j = 0; j < targets.size(); j++) {
+            int t = targets[j];
+            row[j] = ctx.reached(t) ? toUnits(ctx.distance(t)) : numeric_limits<double>::infinity();
+        }
+    }
+    
+    // Semua lokasi yang bisa dicapai dari salah satu sources dengan jarak paling jauh limit (unit
+    // peta), termasuk sources sendiri. visit(lokasi, jarak, source terdekat) dipanggil urut jarak
+    // tepat saat lokasi diproses, jadi hasil yang besar bisa langsung ditulis tanpa disimpan;
+    // pencarian berhenti begitu simpul terdekat di heap melewati limit. Mengembalikan jumlah lokasi.
+    template <typename Visit>
+    int reachableWithin(const vector<int>& sources, double limit, SearchContext& ctx, Visit visit) {
+        ctx.prepare(numLocations);
+        for (int s : sources) {
+            if (ctx.reached(s) || isRemoved(s)) continue;
+            ctx.reach(s, 0, -1);
+            ctx.setLabel(s, s);
+        }
+        double scaled = max(0.0, limit) * WEIGHT_SCALE;
+        PathLength bound = scaled < (double)UNREACHED ? (PathLength)scaled : UNREACHED - 1;
+        int found = 0;
+        while (!ctx.heapEmpty() && ctx.minKey() <= bound) {
+            int u = ctx.popMin();
+            if (ctx.settled(u)) continue;
+            ctx.settle(u);
+            found++;
+            PathLength du = ctx.distance(u);
+            visit(u, toUnits(du), ctx.label(u));
+            
+            ctx.scanned(graph.degree(u));
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.targets[e];
+                PathLength nd = du + graph.weights[e];
+                if (nd <= bound && !ctx.settled(v) && nd < ctx.distance(v)) {
+                    ctx.reach(v, nd, u);
+                    ctx.setLabel(v, ctx.label(u));
+                }
+            }
+        }
+        return found;
+    }
+    
+    // Rute dari source ke setiap targets[j] dengan satu Dijkstra yang berhenti setelah semua
+    // target yang terhubung diproses, misalnya beberapa query dengan lokasi awal sama sekaligus.
+    // Lokasi yang dihapus (source maupun target) tidak punya rute.
+    vector<RouteResult> routesFrom(int source, const vector<int>& targets, SearchContext& ctx) {
+        vector<int> pending;
+        for (int t : targets) {
+            if (!isRemoved(source) && !isRemoved(t) && components.connected(source, t)) pending.push_back(t);
+        }
+        sort(pending.begin(), pending.end());
+        pending.erase(unique(pending.begin(), pending.end()), pending.end());
+        
+        ctx.prepare(numLocations);
+        ctx.reach(source, 0, -1);
+        int remaining = pending.size();
+        int settledNodes = 0;
+        while (!ctx.heapEmpty() && remaining > 0) {
+            int u = ctx.popMin();
+            if (ctx.settled(u)) continue;
+            ctx.settle(u);
+            settledNodes++;
+            if (binary_search(pending.begin(), pending.end(), u)) remaining--;
+            
+            PathLength du = ctx.distance(u);
+            ctx.scanned(graph.degree(u));
+            for (int e = graph.begin(u); e < graph.end(u); e++) {
+                int v = graph.targets[e];
+                PathLength nd = du + graph.weights[e];
+                if (!ctx.settled(v) && nd < ctx.distance(v)) {
+                    ctx.reach(v, nd, u);
+                }
+            }
+        }
+        
+        vector<RouteResult> results(targets.size());
+        for (size_t j = 0; j < targets.size(); j++) {
+            results[j].settledNodes = settledNodes;
+            if (!ctx.settled(targets[j])) continue;
+            results[j].distance = toUnits(ctx.distance(targets[j]));
+            results[j].path = tracePath(ctx, targets[j]);
+        }
+        return results;
+    }
+    
+    // Matriks jarak asal x tujuan (row-major: matrix[i * targets.size() + j]), satu pencarian
+    // per source yang dibagi ke thread pool. threads = 0 berarti pakai semua core. Baris dan
+    // kolom lokasi yang dihapus bernilai tak hingga tanpa pencarian.
+    vector<double> distanceMatrix(const vector<int>& sources, const vector<int>& targets, int threads = 0) {
+        vector<double> matrix(sources.size() * targets.size(), numeric_limits<double>::infinity());
+        vector<char> isTarget(numLocations, 0);
+        unordered_map<int, int> targetsPerComponent;
+        for (int t : targets) {
+            if (isRemoved(t)) continue; // Masih tercatat di komponen lamanya, jadi jangan ditunggu
+            if (!isTarget[t]) targetsPerComponent[components.componentOf(t)]++;
+            isTarget[t] = 1;
+        }
+        
+        WorkStealingPool pool(threads);
+        vector<SearchContext> contexts(pool.workers());
+        pool.run(sources.size(), [&](int i, int worker) {
+            if (isRemoved(sources[i])) return;
+            auto it = targetsPerComponent.find(components.componentOf(sources[i]));
+            int reachableTargets = it != targetsPerComponent.end() ? it->second : 0;
+            oneToMany(sources[i], targets, isTarget, reachableTargets, contexts[worker],
+                      matrix.data() + (size_t)i * targets.size());
+        });
+        return matrix;
+    }
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+
+#include "graph_types.h"
+
+// Radix heap untuk key integer yang monoton: key yang dimasukkan tidak pernah lebih kecil dari
+// key terakhir yang diambil (Dijkstra, dan A* dengan heuristik konsisten). Bucket i berisi entri
+// yang key-nya pertama kali berbeda dari last di bit ke-(i - 1), jadi push O(1) dan setiap entri
+// hanya turun bucket paling banyak 64 kali.
+class RadixHeap {
+private:
+    static const int BUCKETS = 65;
+    vector<pair<PathLength, int>> buckets[BUCKETS];
+    PathLength last = 0;
+    size_t count = 0;
+    
+    static int bucketOf(PathLength key, PathLength last) {
+        return key == last ? 0 : 64 - __builtin_clzll(key ^ last);
+    }
+    
+    // Pastikan bucket 0 (semua key == last = minimum) tidak kosong
+    void refill() {
+        if (!buckets[0].empty()) return;
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        PathLength smallest = buckets[i][0].first;
+        for (const auto& entry : buckets[i]) smallest = min(smallest, entry.first);
+        last = smallest;
+        for (const auto& entry : buckets[i]) buckets[bucketOf(entry.first, last)].push_back(entry);
+        buckets[i].clear();
+    }
+    
+public:
+    void clear() {
+        for (auto& bucket : buckets) bucket.clear();
+        last = 0;
+        count = 0;
+    }
+    
+    bool empty() const { return count == 0; }
+    
+    void push(PathLength key, int v) {
+        // Syarat key >= last dijamin pemanggil: bobot edge tidak pernah terpotong (MAX_EDGE_UNITS)
+        // dan heuristik A* konsisten (HEURISTIC_SCALE), jadi tidak diperiksa lagi di sini
+        buckets[bucketOf(key, last)].push_back({key, v});
+        count++;
+    }
+    
+    // Key minimum (heap tidak boleh kosong)
+    PathLength minKey() {
+        refill();
+        return last;
+    }
+    
+    int pop() {
+        refill();
+        int v = buckets[0].back().second;
+        buckets[0].pop_back();
+        count--;
+        return v;
+    }
+};
+
+// Ruang kerja pencarian yang dipakai ulang antar query (satu per thread). Array dist/prev
+// ditandai dengan nomor generasi, jadi query baru tidak perlu mengosongkan array berukuran n,
+// dan bucket radix heap cukup di-clear.
+class SearchContext {
+private:
+    vector<PathLength> dist;
+    vector<int> prev;
+    vector<unsigned> reachedStamp;
+    vector<unsigned> settledStamp;
+    vector<int32_t> labels;
+    unsigned generation = 0;
+    RadixHeap heap;
+    vector<double> scratch;
+    
+public:
+    SearchCounters counters; // Direset setiap prepare()
+    
+    void prepare(int n) {
+        if ((int)dist.size() != n) {
+            dist.assign(n, 0);
+            prev.assign(n, -1);
+            reachedStamp.assign(n, 0);
+            settledStamp.assign(n, 0);
+            generation = 0;
+        }
+        if (++generation == 0) {
+            // Nomor generasi berputar kembali ke 0: reset stamp sekali saja
+            fill(reachedStamp.begin(), reachedStamp.end(), 0);
+            fill(settledStamp.begin(), settledStamp.end(), 0);
+            generation = 1;
+        }
+        heap.clear();
+        SEARCH_STAT(counters = SearchCounters());
+    }
+    
+    bool reached(int v) const { return reachedStamp[v] == generation; }
+    bool settled(int v) const { return settledStamp[v] == generation; }
+    PathLength distance(int v) const { return reached(v) ? dist[v] : UNREACHED; }
+    int previous(int v) const { return reached(v) ? prev[v] : -1; }
+    
+    // Catat jarak baru untuk v lalu masukkan ke heap dengan prioritas key
+    // (key = d untuk Dijkstra biasa, d + heuristik untuk A*)
+    void reach(int v, PathLength d, int from, PathLength key) {
+        dist[v] = d;
+        prev[v] = from;
+        reachedStamp[v] = generation;
+        SEARCH_STAT(counters.heapPushes++);
+        heap.push(key, v);
+    }
+    
+    void reach(int v, PathLength d, int from) { reach(v, d, from, d); }
+    
+    void settle(int v) {
+        settledStamp[v] = generation;
+        SEARCH_STAT(counters.settled++);
+    }
+    
+    // Catat jumlah edge yang akan diperiksa dari simpul yang baru diproses
+    void scanned([[maybe_unused]] int edges) { SEARCH_STAT(counters.relaxations += edges); }
+    
+    // Label tambahan per simpul, misalnya source asal pada pencarian multi-source. Hanya berlaku
+    // untuk simpul yang reached pada query ini; array dibuat saat pertama kali dipakai.
+    void setLabel(int v, int label) {
+        if (labels.size() != dist.size()) labels.assign(dist.size(), -1);
+        labels[v] = label;
+    }
+    
+    int label(int v) const { return reached(v) && v < (int)labels.size() ? labels[v] : -1; }
+    
+    // Buffer sementara minimal n double (misalnya heuristik semua tetangga satu simpul);
+    // isinya tidak bertahan setelah pemanggilan berikutnya
+    double* scratchBuffer(int n) {
+        if ((int)scratch.size() < n) scratch.resize(n);
+        return scratch.data();
+    }
+    
+    bool heapEmpty() const { return heap.empty(); }
+    PathLength minKey() { return heap.minKey(); }
+    
+    int popMin() {
+        SEARCH_STAT(counters.heapPops++);
+        return heap.pop();
+    }
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <ostream>
+#include <string>
+
+#include "graph_types.h"
+
+// Histogram latensi dengan bucket pangkat dua: bucket b berisi query dengan waktu < 2^b µs
+// (dan >= 2^(b-1) µs). Aman dipakai bersamaan dari banyak thread.
+class LatencyHistogram {
+public:
+    static const int BUCKETS = 32;
+    
+private:
+    atomic<long long> counts[BUCKETS];
+    atomic<long long> total{0};
+    atomic<long long> sumNanos{0};
+    atomic<long long> maxNanos{0};
+    
+public:
+    LatencyHistogram() { reset(); }
+    
+    void reset() {
+        for (auto& c : counts) c.store(0, memory_order_relaxed);
+        total = 0;
+        sumNanos = 0;
+        maxNanos = 0;
+    }
+    
+    static int bucketOf(double micros) {
+        int b = 0;
+        while (b < BUCKETS - 1 && micros >= (double)(1LL << b)) b++;
+        return b;
+    }
+    
+    void record(double micros) {
+        long long nanos = (long long)(micros * 1000);
+        counts[bucketOf(micros)].fetch_add(1, memory_order_relaxed);
+        total.fetch_add(1, memory_order_relaxed);
+        sumNanos.fetch_add(nanos, memory_order_relaxed);
+        long long seen = maxNanos.load(memory_order_relaxed);
+        while (nanos > seen && !maxNanos.compare_exchange_weak(seen, nanos, memory_order_relaxed)) {
+        }
+    }
+    
+    long long count() const { return total.load(memory_order_relaxed); }
+    long long bucket(int b) const { return counts[b].load(memory_order_relaxed); }
+    double meanMicros() const { return count() ? sumNanos.load() / 1000.0 / count() : 0; }
+    double maxMicros() const { return maxNanos.load() / 1000.0; }
+    
+    // Batas atas bucket yang memuat persentil p (0..1), dalam µs
+    double percentileMicros(double p) const {
+        long long n = count();
+        if (n == 0) return 0;
+        long long rank = (long long)(p * (n - 1)) + 1;
+        long long seen = 0;
+        for (int b = 0; b < BUCKETS; b++) {
+            seen += bucket(b);
+            if (seen >= rank) return (double)(1LL << b);
+        }
+        return maxMicros();
+    }
+};
+
+// Statistik gabungan semua query findRoute selama program berjalan, per algoritma
+class SessionStats {
+private:
+    struct ModeStats {
+        LatencyHistogram latency;
+        atomic<long long> heapPushes{0}, heapPops{0}, relaxations{0}, settled{0};
+    };
+    ModeStats modes[SEARCH_MODE_COUNT];
+    
+public:
+    void record(SearchMode mode, const RouteResult& route) {
+        ModeStats& m = modes[mode];
+        m.latency.record(route.micros);
+        m.heapPushes.fetch_add(route.counters.heapPushes, memory_order_relaxed);
+        m.heapPops.fetch_add(route.counters.heapPops, memory_order_relaxed);
+        m.relaxations.fetch_add(route.counters.relaxations, memory_order_relaxed);
+        m.settled.fetch_add(route.counters.settled, memory_order_relaxed);
+    }
+    
+    void reset() {
+        for (ModeStats& m : modes) {
+            m.latency.reset();
+            m.heapPushes = m.heapPops = m.relaxations = m.settled = 0;
+        }
+    }
+    
+    long long queries() const {
+        long long n = 0;
+        for (const ModeStats& m : modes) n += m.latency.count();
+        return n;
+    }
+    
+    // Ringkasan untuk menu: rata-rata penghitung per query dan histogram latensi
+    void print(ostream& out) const {
+        char line[160];
+        for (int mode = 0; mode < SEARCH_MODE_COUNT; mode++) {
+            const ModeStats& m = modes[mode];
+            long long n = m.latency.count();
+            if (n == 0) continue;
+            out << "\n" << searchModeName((SearchMode)mode) << ": " << n << " query" << endl;
+            snprintf(line, sizeof(line), "  Rata-rata per query: %.1f heap push, %.1f pop basi, %.1f edge diperiksa, %.1f simpul",
+                     (double)m.heapPushes / n, (double)(m.heapPops - m.settled) / n, (double)m.relaxations / n,
+                     (double)m.settled / n);
+            out << line << endl;
+            snprintf(line, sizeof(line), "  Latensi: rata-rata %.1f us, p50 <= %.0f us, p99 <= %.0f us, maks %.1f us",
+                     m.latency.meanMicros(), m.latency.percentileMicros(0.5), m.latency.percentileMicros(0.99),
+                     m.latency.maxMicros());
+            out << line << endl;
+            for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+                long long c = m.latency.bucket(b);
+                if (c == 0) continue;
+                snprintf(line, sizeof(line), "    < %10lld us: %8lld ", 1LL << b, c);
+                out << line << string(max(1LL, c * 40 / n), '#') << endl;
+            }
+        }
+    }
+    
+    // Satu objek JSON: {"queries":N,"modes":{"dijkstra":{...},...}}
+    string toJson() const {
+        string json = "{\"queries\":" + to_string(queries()) + ",\"modes\":{";
+        bool first = true;
+        char number[256];
+        for (int mode = 0; mode < SEARCH_MODE_COUNT; mode++) {
+            const ModeStats& m = modes[mode];
+            long long n = m.latency.count();
+            if (n == 0) continue;
+            if (!first) json += ',';
+            first = false;
+            snprintf(number, sizeof(number),
+                     "\"%s\":{\"queries\":%lld,\"heap_pushes\":%lld,\"stale_pops\":%lld,\"relaxations\":%lld,"
+                     "\"settled\":%lld,\"mean_us\":%.1f,\"p50_us\":%.0f,\"p99_us\":%.0f,\"max_us\":%.1f,\"histogram_us\":{",
+                     searchModeKey((SearchMode)mode), n, m.heapPushes.load(), m.heapPops.load() - m.settled.load(),
+                     m.relaxations.load(), m.settled.load(), m.latency.meanMicros(), m.latency.percentileMicros(0.5),
+                     m.latency.percentileMicros(0.99), m.latency.maxMicros());
+            json += number;
+            bool firstBucket = true;
+            for (int b = 0; b < LatencyHistogram::BUCKETS; b++) {
+                long long c = m.latency.bucket(b);
+                if (c == 0) continue;
+                if (!firstBucket) json += ',';
+                firstBucket = false;
+                json += "\"<" + to_string(1LL << b) + "\":" + to_string(c);
+            }
+            json += "}}";
+        }
+        return json + "}}";
+    }
+};
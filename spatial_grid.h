@@ -0,0 +1,295 @@
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+
+#include "distance_kernels.h"
+#include "graph_types.h"
+
+// Batas sel pada satu sumbu grid. Batas diambil dari kuantil koordinat, bukan dari bounding box,
+// sehingga satu titik yang sangat jauh hanya melebarkan sel terakhir dan tidak membuat semua sel
+// lain kosong. Sel c mencakup [starts[c], starts[c + 1]); sel pertama dan terakhir tidak berbatas.
+struct GridAxis {
+    static const int SAMPLE_LIMIT = 65536; // Kuantil cukup diperkirakan dari sampel sebesar ini
+    vector<int32_t> starts;
+    
+    int cells() const { return starts.size(); }
+    
+    int cellOf(int v) const {
+        int c = (int)(upper_bound(starts.begin(), starts.end(), v) - starts.begin()) - 1;
+        return max(0, c);
+    }
+    
+    // Jarak dari v ke batas kiri sel c0 dan ke batas kanan sel c1 (tak hingga di tepi grid):
+    // titik di luar rentang sel c0..c1 pasti sejauh ini dari v
+    double distanceOutside(int v, int c0, int c1) const {
+        double inf = numeric_limits<double>::infinity();
+        double low = c0 > 0 ? (double)v - starts[c0] : inf;
+        double high = c1 + 1 < cells() ? (double)starts[c1 + 1] - v : inf;
+        return min(low, high);
+    }
+    
+    // Sampel deterministik (setiap n/SAMPLE_LIMIT titik) yang sudah diurutkan
+    static vector<int32_t> sortedSample(const int32_t* values, int n) {
+        size_t stride = max<size_t>(1, (size_t)n / SAMPLE_LIMIT);
+        vector<int32_t> sample;
+        for (size_t i = 0; i < (size_t)n; i += stride) sample.push_back(values[i]);
+        sort(sample.begin(), sample.end());
+        return sample;
+    }
+    
+    // Sebaran inti data (kuantil 1% - 99%), tidak terpengaruh segelintir pencilan
+    static double spread(const vector<int32_t>& sample) {
+        size_t low = sample.size() / 100, high = sample.size() - 1 - sample.size() / 100;
+        return max(1.0, (double)sample[high] - sample[low]);
+    }
+    
+    // count sel dengan jumlah titik sampel yang kira-kira sama; batas ganda dibuang
+    static GridAxis fromSample(const vector<int32_t>& sample, int count) {
+        GridAxis axis;
+        count = max(1, min(count, (int)sample.size()));
+        for (int c = 0; c < count; c++) {
+            int32_t start = sample[(size_t)c * sample.size() / count];
+            if (axis.starts.empty() || start > axis.starts.back()) axis.starts.push_back(start);
+        }
+        return axis;
+    }
+    
+    // Bagi n titik ke sekitar cellCount sel: jumlah kolom dan baris sesuai perbandingan sebaran
+    // inti data agar sel kira-kira persegi. Jumlah sel hasilnya tidak lebih dari cellCount.
+    static void split(const int32_t* xs, const int32_t* ys, int n, double cellCount, GridAxis& columns, GridAxis& rows) {
+        vector<int32_t> sampleX = sortedSample(xs, n);
+        vector<int32_t> sampleY = sortedSample(ys, n);
+        double aspect = spread(sampleX) / spread(sampleY);
+        cellCount = max(1.0, floor(cellCount));
+        int wantCols = (int)min(cellCount, max(1.0, round(sqrt(cellCount * aspect))));
+        int wantRows = (int)max(1.0, floor(cellCount / wantCols));
+        columns = fromSample(sampleX, wantCols);
+        rows = fromSample(sampleY, wantRows);
+    }
+};
+
+// Grid untuk mencari tetangga terdekat tanpa membandingkan semua pasangan titik. Batas kolom dan
+// baris dari kuantil (GridAxis), jadi rata-rata sekitar 2 titik per sel juga untuk data yang
+// berkelompok atau punya pencilan; build O(n log n).
+class SpatialGrid {
+private:
+    const LocationTable* points = nullptr;
+    GridAxis columns, rowAxis;
+    int cols = 0, rows = 0;
+    vector<int> cellStart; // Offset awal tiap sel di cellItems (counting sort)
+    vector<int> cellItems; // Indeks titik, dikelompokkan per sel
+    vector<int32_t> cellXs, cellYs; // Koordinat titik dengan urutan sama seperti cellItems
+    
+    // Perubahan setelah build (pembaruan inkremental): titik baru per sel dan tanda titik dihapus.
+    // Batas sel tidak berubah; titik di luar rentang awal masuk ke sel tepi.
+    unordered_map<int, vector<int>> insertedItems;
+    vector<char> removedFlag;
+    
+    int cellX(int x) const { return columns.cellOf(x); }
+    int cellY(int y) const { return rowAxis.cellOf(y); }
+    
+    // Hitung jarak (x, y) ke count titik sekaligus lalu masukkan ke daftar kandidat. Titik ke-k
+    // adalah ids[k] dengan koordinat xs/ys[k] (atau xs/ys[indices[k]] jika indices tidak null).
+    void collectBlock(int x, int y, const int32_t* xs, const int32_t* ys, const int32_t* indices,
+                      const int* ids, int count, int exclude, vector<pair<double, int>>& candidates) const {
+        const int BLOCK = 64;
+        double distances[BLOCK];
+        for (int begin = 0; begin < count; begin += BLOCK) {
+            int size = min(BLOCK, count - begin);
+            if (indices) {
+                distancesFrom(x, y, xs, ys, indices + begin, size, distances);
+            } else {
+                distancesFrom(x, y, xs + begin, ys + begin, nullptr, size, distances);
+            }
+            for (int k = 0; k < size; k++) {
+                int j = ids[begin + k];
+                if (j == exclude || (j < (int)removedFlag.size() && removedFlag[j])) continue;
+                candidates.push_back({distances[k], j});
+            }
+        }
+    }
+    
+    // Masukkan semua titik pada sel (c0..c1, row) ke daftar kandidat. Sel-sel satu baris
+    // bersebelahan di cellItems, jadi satu rentang cukup untuk semuanya.
+    void collectRow(int c0, int c1, int row, int x, int y, int exclude, vector<pair<double, int>>& candidates) const {
+        if (row < 0 || row >= rows) return;
+        c0 = max(c0, 0);
+        c1 = min(c1, cols - 1);
+        if (c0 > c1) return;
+        int begin = cellStart[row * cols + c0], end = cellStart[row * cols + c1 + 1];
+        collectBlock(x, y, cellXs.data() + begin, cellYs.data() + begin, nullptr, cellItems.data() + begin,
+                     end - begin, exclude, candidates);
+        if (insertedItems.empty()) return;
+        for (int c = c0; c <= c1; c++) {
+            auto it = insertedItems.find(row * cols + c);
+            if (it == insertedItems.end()) continue;
+            const vector<int>& items = it->second;
+            collectBlock(x, y, points->xs, points->ys, items.data(), items.data(), items.size(), exclude, candidates);
+        }
+    }
+    
+public:
+    void build(const LocationTable& pts) {
+        points = &pts;
+        insertedItems.clear();
+        removedFlag.clear();
+        int n = pts.size();
+        if (n == 0) {
+            cols = rows = 0;
+            cellStart.assign(1, 0);
+            cellItems.clear();
+            cellXs.clear();
+            cellYs.clear();
+            return;
+        }
+        
+        // Sekitar 2 titik per sel
+        GridAxis::split(pts.xs, pts.ys, n, n / 2.0, columns, rowAxis);
+        cols = columns.cells();
+        rows = rowAxis.cells();
+        
+        // Sel tiap titik dicari sekali (pencarian biner pada batas sel) lalu dipakai dua kali
+        vector<int> cellOfPoint(n);
+        cellStart.assign((size_t)cols * rows + 1, 0);
+        cellItems.assign(n, 0);
+        for (int i = 0; i < n; i++) {
+            cellOfPoint[i] = cellY(pts.ys[i]) * cols + cellX(pts.xs[i]);
+            cellStart[cellOfPoint[i] + 1]++;
+        }
+        for (size_t c = 1; c < cellStart.size(); c++) {
+            cellStart[c] += cellStart[c - 1];
+        }
+        vector<int> fill(cellStart.begin(), cellStart.end() - 1);
+        for (int i = 0; i < n; i++) {
+            cellItems[fill[cellOfPoint[i]]++] = i;
+        }
+        cellXs.resize(n);
+        cellYs.resize(n);
+        for (int k = 0; k < n; k++) {
+            cellXs[k] = pts.xs[cellItems[k]];
+            cellYs[k] = pts.ys[cellItems[k]];
+        }
+    }
+    
+    // Semua titik hasil build, dikelompokkan per sel (baris demi baris)
+    const vector<int>& cellOrder() const { return cellItems; }
+    
+    // Tambahkan titik i (sudah ada di tabel lokasi) ke grid yang sudah dibangun
+    void insert(int i) {
+        int cell = cellY(points->ys[i]) * cols + cellX(points->xs[i]);
+        insertedItems[cell].push_back(i);
+        if (i < (int)removedFlag.size()) removedFlag[i] = 0;
+    }
+    
+    // Titik i tidak lagi ikut dalam hasil pencarian
+    void remove(int i) {
+        if (i >= (int)removedFlag.size()) removedFlag.resize(points->size(), 0);
+        removedFlag[i] = 1;
+    }
+    
+    // Cari k titik terdekat dari (x, y), terurut berdasarkan (jarak, indeks) seperti sort biasa.
+    // Pencarian berhenti lebih awal jika semua titik dalam radius sudah pasti ditemukan dan
+    // minimal minCount titik terdekat sudah pasti; hasil di luar radius bisa tidak lengkap.
+    void kNearest(int x, int y, int k, int exclude, double radius, int minCount,
+                  vector<pair<double, int>>& result) const {
+        result.clear();
+        if (cols == 0 || k <= 0) return;
+        
+        int cx = cellX(x), cy = cellY(y);
+        int maxRing = max(max(cx, cols - 1 - cx), max(cy, rows - 1 - cy));
+        
+        for (int ring = 0; ring <= maxRing; ring++) {
+            int c0 = cx - ring, c1 = cx + ring, r0 = cy - ring, r1 = cy + ring;
+            if (ring == 0) {
+                collectRow(cx, cx, cy, x, y, exclude, result);
+            } else {
+                // Hanya bagian ring yang ada di dalam grid
+                collectRow(c0, c1, r0, x, y, exclude, result);
+                collectRow(c0, c1, r1, x, y, exclude, result);
+                for (int r = max(r0 + 1, 0); r <= min(r1 - 1, rows - 1); r++) {
+                    if (c0 >= 0) collectRow(c0, c0, r, x, y, exclude, result);
+                    if (c1 < cols) collectRow(c1, c1, r, x, y, exclude, result);
+                }
+            }
+            
+            // Titik di luar sel yang sudah diperiksa berjarak minimal certain dari (x, y)
+            double certain = min(columns.distanceOutside(x, c0, c1), rowAxis.distanceOutside(y, r0, r1));
+            int certainCount = 0;
+            for (const auto& c : result) {
+                if (c.first < certain) certainCount++;
+            }
+            if (certainCount >= k) break;
+            if (certain > radius && certainCount >= minCount) break;
+        }
+        
+        // Hanya k teratas yang perlu terurut; sisanya dibuang
+        if ((int)result.size() > k) {
+            partial_sort(result.begin(), result.begin() + k, result.end());
+            result.resize(k);
+        } else {
+            sort(result.begin(), result.end());
+        }
+    }
+};
+
+// Titik yang masing-masing punya radius jangkauan. Query mencari semua titik yang radiusnya
+// mungkin mencapai (x, y), tanpa memeriksa semua titik. Titik dikelompokkan per kelas radius
+// (pangkat dua); kelas k disimpan di grid hash dengan sel 2^k, sehingga titik yang mencapai
+// (x, y) pasti ada di 3x3 sel sekitar (x, y). Hasil query bisa berlebih: pemanggil tetap
+// memeriksa jarak sebenarnya.
+class RadiusIndex {
+private:
+    static const int CLASSES = 63;
+    vector<unordered_map<uint64_t, vector<int>>> cells = vector<unordered_map<uint64_t, vector<int>>>(CLASSES);
+    vector<int> classSize = vector<int>(CLASSES, 0);
+    vector<signed char> classOf; // -1 = titik tidak ada di index
+    
+    static int radiusClass(double radius) {
+        int k = 0;
+        while (k < CLASSES - 1 && (double)(1LL << k) < radius) k++;
+        return k;
+    }
+    
+    static uint64_t cellKey(long long cx, long long cy) {
+        return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy;
+    }
+    
+public:
+    // Masukkan atau perbarui titik i di (x, y) dengan radius tertentu (boleh tak hingga)
+    void insert(int i, int x, int y, double radius) {
+        erase(i, x, y);
+        if (i >= (int)classOf.size()) classOf.resize(i + 1, -1);
+        int k = radiusClass(radius);
+        cells[k][cellKey((long long)x >> k, (long long)y >> k)].push_back(i);
+        classSize[k]++;
+        classOf[i] = k;
+    }
+    
+    // Keluarkan titik i (di (x, y) seperti saat insert); tidak apa-apa jika tidak ada
+    void erase(int i, int x, int y) {
+        if (i >= (int)classOf.size() || classOf[i] < 0) return;
+        int k = classOf[i];
+        auto it = cells[k].find(cellKey((long long)x >> k, (long long)y >> k));
+        vector<int>& items = it->second;
+        *find(items.begin(), items.end(), i) = items.back();
+        items.pop_back();
+        if (items.empty()) cells[k].erase(it);
+        classSize[k]--;
+        classOf[i] = -1;
+    }
+    
+    void query(int x, int y, vector<int>& result) const {
+        for (int k = 0; k < CLASSES; k++) {
+            if (classSize[k] == 0) continue;
+            long long cx = (long long)x >> k, cy = (long long)y >> k;
+            for (long long dy = -1; dy <= 1; dy++) {
+                for (long long dx = -1; dx <= 1; dx++) {
+                    auto it = cells[k].find(cellKey(cx + dx, cy + dy));
+                    if (it != cells[k].end()) result.insert(result.end(), it->second.begin(), it->second.end());
+                }
+            }
+        }
+    }
+};
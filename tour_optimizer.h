@@ -0,0 +1,274 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <random>
+
+#include "road_network.h"
+#include "work_stealing_pool.h"
+
+// Putaran gangguan berturut-turut tanpa perbaikan (per stop) sebelum satu thread berhenti
+const int TOUR_STALL_ROUNDS_PER_STOP = 50;
+
+// Pilihan perencanaan rute banyak tujuan (planTour)
+struct TourOptions {
+    bool returnToStart = false;   // Setelah tujuan terakhir kembali ke lokasi awal
+    double budgetMs = 200;        // Waktu perbaikan urutan; 0 = satu putaran deterministik saja
+    int threads = 0;              // 0 = semua core
+    unsigned long long seed = 42;
+};
+
+struct TourPlan {
+    vector<int> order;            // Lokasi (0-based) dalam urutan kunjungan; order[0] = lokasi awal
+    vector<double> legs;          // Jarak tiap kaki order[k] -> order[k + 1] (unit peta)
+    vector<int> path;             // Jalur lengkap lewat jalan: sambungan jalur semua kaki
+    double distance = numeric_limits<double>::infinity();
+    double initialDistance = 0;   // Panjang urutan nearest insertion sebelum diperbaiki
+    int rounds = 0;               // Jumlah putaran local search di semua thread
+    double tableMs = 0, optimizeMs = 0, stitchMs = 0;
+    string error;                 // Terisi jika rute tidak bisa dibuat
+};
+
+// Urutan kunjungan di atas tabel jarak n x n (row-major, simetris seperti graph jalan). Rute
+// dimulai dari stop 0; tanpa closed rute berakhir di stop mana pun. Posisi n dalam tour berarti
+// "setelah stop terakhir": sambungan ke sana gratis, atau kembali ke stop 0 jika closed.
+class TourOptimizer {
+private:
+    static constexpr double EPSILON = 1e-7; // Perbaikan lebih kecil dari ini dianggap pembulatan
+    static const int END = -1;
+    const vector<double>& table;
+    int n;
+    bool closed;
+    
+    double cost(int a, int b) const {
+        if (b == END) return closed ? table[(size_t)a * n] : 0;
+        return table[(size_t)a * n + b];
+    }
+    
+    int at(const vector<int>& tour, int k) const { return k < n ? tour[k] : END; }
+    
+public:
+    TourOptimizer(const vector<double>& table, int n, bool closed) : table(table), n(n), closed(closed) {}
+    
+    double length(const vector<int>& tour) const {
+        double total = 0;
+        for (int k = 0; k < n; k++) total += cost(tour[k], at(tour, k + 1));
+        return total;
+    }
+    
+    // Nearest insertion: stop terdekat ke rute yang sudah ada disisipkan di posisi termurah.
+    // Dengan rng, stop pertama setelah lokasi awal dipilih acak (awal berbeda untuk restart).
+    vector<int> nearestInsertion(mt19937_64* rng) const {
+        vector<int> tour = {0};
+        vector<char> inTour(n, 0);
+        vector<double> nearest(n);
+        inTour[0] = 1;
+        for (int v = 0; v < n; v++) nearest[v] = cost(0, v);
+        int seeded = rng && n > 1 ? uniform_int_distribution<int>(1, n - 1)(*rng) : -1;
+        
+        for (int added = 1; added < n; added++) {
+            int pick = seeded;
+            if (pick < 0) {
+                for (int v = 1; v < n; v++) {
+                    if (!inTour[v] && (pick < 0 || nearest[v] < nearest[pick])) pick = v;
+                }
+            }
+            seeded = -1;
+            
+            int bestSlot = 0;
+            double bestDelta = numeric_limits<double>::infinity();
+            for (int k = 0; k < (int)tour.size(); k++) {
+                int a = tour[k], b = k + 1 < (int)tour.size() ? tour[k + 1] : END;
+                double delta = cost(a, pick) + cost(pick, b) - cost(a, b);
+                if (delta < bestDelta) {
+                    bestDelta = delta;
+                    bestSlot = k + 1;
+                }
+            }
+            tour.insert(tour.begin() + bestSlot, pick);
+            inTour[pick] = 1;
+            for (int v = 0; v < n; v++) nearest[v] = min(nearest[v], cost(pick, v));
+        }
+        return tour;
+    }
+    
+    // Satu lintasan 2-opt: balik tour[i..j] jika memendekkan rute
+    bool twoOpt(vector<int>& tour) const {
+        bool improved = false;
+        for (int i = 1; i < n - 1; i++) {
+            for (int j = i + 1; j < n; j++) {
+                int a = tour[i - 1], b = tour[i], c = tour[j], d = at(tour, j + 1);
+                double delta = cost(a, c) + cost(b, d) - cost(a, b) - cost(c, d);
+                if (delta < -EPSILON) {
+                    reverse(tour.begin() + i, tour.begin() + j + 1);
+                    improved = true;
+                }
+            }
+        }
+        return improved;
+    }
+    
+    // Satu lintasan Or-opt: pindahkan potongan 1-3 stop (boleh terbalik) ke posisi lain
+    bool orOpt(vector<int>& tour) const {
+        bool improved = false;
+        for (int length = 1; length <= 3; length++) {
+            for (int i = 1; i + length <= n; i++) {
+                int e = i + length - 1;
+                int s = tour[i], t = tour[e];
+                int before = tour[i - 1], after = at(tour, e + 1);
+                double removed = cost(before, s) + cost(t, after) - cost(before, after);
+                
+                int bestSlot = -1;
+                bool bestReversed = false;
+                double bestDelta = -EPSILON;
+                for (int k = 0; k < n; k++) {
+                    if (k >= i - 1 && k <= e) continue;
+                    int a = tour[k], b = at(tour, k + 1);
+                    double forward = cost(a, s) + cost(t, b) - cost(a, b) - removed;
+                    double backward = cost(a, t) + cost(s, b) - cost(a, b) - removed;
+                    if (forward < bestDelta) {
+                        bestDelta = forward;
+                        bestSlot = k;
+                        bestReversed = false;
+                    }
+                    if (backward < bestDelta) {
+                        bestDelta = backward;
+                        bestSlot = k;
+                        bestReversed = true;
+                    }
+                }
+                if (bestSlot < 0) continue;
+                
+                vector<int> segment(tour.begin() + i, tour.begin() + e + 1);
+                if (bestReversed) reverse(segment.begin(), segment.end());
+                int anchor = tour[bestSlot];
+                tour.erase(tour.begin() + i, tour.begin() + e + 1);
+                int slot = find(tour.begin(), tour.end(), anchor) - tour.begin() + 1;
+                tour.insert(tour.begin() + slot, segment.begin(), segment.end());
+                improved = true;
+            }
+        }
+        return improved;
+    }
+    
+    void localSearch(vector<int>& tour) const {
+        while (twoOpt(tour) || orOpt(tour)) {
+        }
+    }
+    
+    // Double bridge: A B C D -> A C B D dengan A diawali lokasi awal; keluar dari optimum lokal
+    // yang tidak bisa ditembus 2-opt/Or-opt
+    void perturb(vector<int>& tour, mt19937_64& rng) const {
+        if (n < 5) return;
+        uniform_int_distribution<int> position(1, n - 1);
+        int cuts[3];
+        do {
+            for (int& c : cuts) c = position(rng);
+            sort(cuts, cuts + 3);
+        } while (cuts[0] == cuts[1] || cuts[1] == cuts[2]);
+        rotate(tour.begin() + cuts[0], tour.begin() + cuts[1], tour.begin() + cuts[2]);
+    }
+};
+
+// Rute banyak tujuan: tabel jarak antar semua stop (paralel, satu pencarian per stop), urutan
+// kunjungan dari nearest insertion + 2-opt/Or-opt yang diulang di setiap thread dengan awal dan
+// gangguan berbeda sampai budget habis, lalu jalur tiap kaki disambung. stops[0] = lokasi awal;
+// stop ganda hanya dikunjungi sekali.
+inline TourPlan planTour(RoadNetwork& network, const vector<int>& stops, const TourOptions& options) {
+    TourPlan plan;
+    vector<int> visits;
+    for (int s : stops) {
+        if (find(visits.begin(), visits.end(), s) == visits.end()) visits.push_back(s);
+    }
+    if (visits.empty()) {
+        plan.error = "butuh minimal satu lokasi";
+        return plan;
+    }
+    for (int s : visits) {
+        if (network.isRemoved(s)) {
+            plan.error = "lokasi " + to_string(s + 1) + " sudah dihapus";
+            return plan;
+        }
+    }
+    int n = visits.size();
+    auto lap = [](chrono::steady_clock::time_point& since) {
+        auto now = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(now - since).count();
+        since = now;
+        return ms;
+    };
+    auto began = chrono::steady_clock::now();
+    
+    vector<double> table = network.distanceMatrix(visits, visits, options.threads);
+    plan.tableMs = lap(began);
+    // Graph dua arah: cukup periksa baris lokasi awal
+    for (int v = 1; v < n; v++) {
+        if (isinf(table[v])) {
+            plan.error = "lokasi " + to_string(visits[v] + 1) + " tidak terhubung dengan lokasi awal";
+            return plan;
+        }
+    }
+    
+    TourOptimizer optimizer(table, n, options.returnToStart);
+    vector<int> initial = optimizer.nearestInsertion(nullptr);
+    plan.initialDistance = optimizer.length(initial);
+    
+    // Thread 0 mulai dari urutan deterministik, thread lain dari stop pertama acak; setiap thread
+    // lalu mengganggu rute terbaiknya sendiri dan memperbaikinya lagi sampai budget habis
+    WorkStealingPool pool(options.threads);
+    int workers = options.budgetMs > 0 ? pool.workers() : 1;
+    auto deadline = began + chrono::duration_cast<chrono::steady_clock::duration>(
+                                chrono::duration<double, milli>(options.budgetMs));
+    vector<vector<int>> best(workers);
+    vector<double> bestLength(workers);
+    atomic<int> rounds(0);
+    pool.run(workers, [&](int w, int) {
+        mt19937_64 rng(options.seed + w);
+        vector<int> tour = w == 0 ? initial : optimizer.nearestInsertion(&rng);
+        optimizer.localSearch(tour);
+        best[w] = tour;
+        bestLength[w] = optimizer.length(tour);
+        rounds++;
+        // Berhenti lebih awal jika lama tidak ada perbaikan (rute kecil cepat mentok di optimum)
+        int stalled = 0;
+        while (chrono::steady_clock::now() < deadline && n >= 5 && stalled < TOUR_STALL_ROUNDS_PER_STOP * n) {
+            tour = best[w];
+            optimizer.perturb(tour, rng);
+            optimizer.localSearch(tour);
+            double length = optimizer.length(tour);
+            stalled++;
+            if (length < bestLength[w] - 1e-7) {
+                best[w] = tour;
+                bestLength[w] = length;
+                stalled = 0;
+            }
+            rounds++;
+        }
+    });
+    int winner = min_element(bestLength.begin(), bestLength.end()) - bestLength.begin();
+    for (int k : best[winner]) plan.order.push_back(visits[k]);
+    if (options.returnToStart && n > 1) plan.order.push_back(visits[0]);
+    plan.rounds = rounds;
+    plan.optimizeMs = lap(began);
+    
+    // Jalur tiap kaki dicari paralel, lalu disambung tanpa mengulang lokasi sambungan
+    int legCount = plan.order.size() - 1;
+    vector<RouteResult> legRoutes(legCount);
+    vector<SearchContext> contexts(pool.workers());
+    pool.run(legCount, [&](int k, int worker) {
+        legRoutes[k] = network.routesFrom(plan.order[k], {plan.order[k + 1]}, contexts[worker])[0];
+    });
+    plan.path = {plan.order[0]};
+    plan.distance = 0;
+    for (const RouteResult& leg : legRoutes) {
+        if (leg.path.empty()) {
+            plan.error = "jalur antar lokasi tidak ditemukan";
+            return plan;
+        }
+        plan.path.insert(plan.path.end(), leg.path.begin() + 1, leg.path.end());
+        plan.legs.push_back(leg.distance);
+        plan.distance += leg.distance;
+    }
+    plan.stitchMs = lap(began);
+    return plan;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "graph_types.h"
+
+// Pool thread dengan work stealing: tugas dibagi rata ke antrian milik tiap worker, worker
+// mengambil dari belakang antriannya sendiri dan mencuri dari depan antrian worker lain
+// bila antriannya kosong, sehingga source yang lambat tidak membuat thread lain menganggur.
+class WorkStealingPool {
+private:
+    struct TaskQueue {
+        mutex lock;
+        deque<int> tasks;
+    };
+    int workerCount;
+    
+    static bool takeOwn(TaskQueue& q, int& task) {
+        lock_guard<mutex> guard(q.lock);
+        if (q.tasks.empty()) return false;
+        task = q.tasks.back();
+        q.tasks.pop_back();
+        return true;
+    }
+    
+    static bool steal(TaskQueue& q, int& task) {
+        lock_guard<mutex> guard(q.lock);
+        if (q.tasks.empty()) return false;
+        task = q.tasks.front();
+        q.tasks.pop_front();
+        return true;
+    }
+    
+public:
+    explicit WorkStealingPool(int threads = 0) {
+        workerCount = threads > 0 ? threads : max(1u, thread::hardware_concurrency());
+    }
+    
+    int workers() const { return workerCount; }
+    
+    // Jalankan job(task, worker) untuk task = 0..taskCount-1; kembali setelah semua selesai
+    void run(int taskCount, const function<void(int, int)>& job) {
+        int active = min(workerCount, max(1, taskCount));
+        vector<TaskQueue> queues(active);
+        for (int t = 0; t < taskCount; t++) {
+            queues[t % active].tasks.push_back(t);
+        }
+        
+        auto work = [&](int worker) {
+            int task;
+            while (true) {
+                bool found = takeOwn(queues[worker], task);
+                for (int k = 1; !found && k < active; k++) {
+                    found = steal(queues[(worker + k) % active], task);
+                }
+                // Tugas tidak pernah ditambah setelah mulai, jadi semua antrian kosong = selesai
+                if (!found) return;
+                job(task, worker);
+            }
+        };
+        
+        vector<thread> threads;
+        for (int w = 1; w < active; w++) {
+            threads.emplace_back(work, w);
+        }
+        work(0);
+        for (thread& t : threads) {
+            t.join();
+        }
+    }
+};